@@ -0,0 +1,284 @@
+#pragma once
+
+#include <queue>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <unordered_map>
+#include <algorithm>
+
+typedef std::vector<int> clause_t;
+
+#define BVA_WORK_BUDGET 100000000UL
+
+/**
+ * @brief Bounded variable addition [Manthey et al., 2012]. If for a set
+ *        of literals L and a set of clauses R every clause l | r (l in L,
+ *        r in R) is in the formula, these |L| * |R| clauses are replaced
+ *        by the |L| + |R| clauses l | x and r | -x over a fresh variable
+ *        x, whenever that is fewer. Pairwise at-most-one constraints are
+ *        such bicliques of binary clauses. L grows greedily from the most
+ *        occurring literal, taken from a priority queue, by the literal
+ *        completing the most clauses of R.
+ */
+class BVA {
+
+public:
+
+    BVA(std::vector<clause_t> &clauses, int maxVarIndex) {
+
+        this->clauses = &clauses;
+        this->maxVarIndex = maxVarIndex;
+        this->nOriginalClauses = clauses.size();
+        this->nAddedVars = 0U;
+        this->work = 0UL;
+        this->occurrences.resize(2 * (maxVarIndex + 1));
+        this->counts.resize(2 * (maxVarIndex + 1), 0UL);
+
+        // Clauses with repeated variables or seen before are left alone.
+        // Sorting by variable puts both literals of a variable side by side.
+        for (const auto &clause : clauses) {
+            clause_t lits = clause;
+            std::sort(lits.begin(), lits.end(), [](int a, int b) {
+                return std::abs(a) < std::abs(b);
+            });
+            bool eligible = lits.size() >= 2;
+            for (size_t i = 1; i < lits.size() && eligible; ++i)
+                eligible = std::abs(lits[i - 1]) != std::abs(lits[i]);
+            std::sort(lits.begin(), lits.end());
+            eligible = eligible && !this->index.count(lits);
+            this->store.push_back(lits);
+            this->alive.push_back(true);
+            if (eligible)
+                this->insert(this->store.size() - 1);
+        }
+    }
+
+    /**
+     * @brief Replace bicliques until no literal yields a reduction or the
+     *        work budget runs out. Untouched clauses keep their order and
+     *        the added ones follow.
+     * @return The new maxVarIndex
+     */
+    int run() {
+
+        std::priority_queue<std::pair<size_t, int> > queue;
+        for (int var = 1; var <= this->maxVarIndex; ++var)
+            for (int lit : {var, -var})
+                if (this->counts[slot(lit)] >= 2)
+                    queue.emplace(this->counts[slot(lit)], lit);
+
+        while (!queue.empty() && this->work < BVA_WORK_BUDGET) {
+
+            auto top = queue.top();
+            queue.pop();
+            int l = top.second;
+            // Stale entries are queued again with the current count
+            if (top.first != this->counts[slot(l)]) {
+                if (this->counts[slot(l)] >= 2)
+                    queue.emplace(this->counts[slot(l)], l);
+                continue;
+            }
+
+            std::vector<int> lits = {l};
+            std::vector<size_t> matched;
+            for (size_t id : this->occurrences[slot(l)])
+                if (this->alive[id])
+                    matched.push_back(id);
+            this->extend(l, lits, matched);
+            if (reduction(lits.size(), matched.size()) <= 0)
+                continue;
+
+            this->replace(l, lits, matched);
+            for (int lit : lits)
+                queue.emplace(this->counts[slot(lit)], lit);
+            queue.emplace(this->counts[slot(-this->maxVarIndex)], -this->maxVarIndex);
+        }
+
+        // The first clauses are moved back where they were, so clauses
+        // which were not eligible keep their literal order
+        std::vector<clause_t> result;
+        result.reserve(this->store.size());
+        for (size_t id = 0; id < this->store.size(); ++id) {
+            if (!this->alive[id])
+                continue;
+            if (id < this->nOriginalClauses)
+                result.push_back(std::move((*this->clauses)[id]));
+            else
+                result.push_back(std::move(this->store[id]));
+        }
+        this->nRemovedClauses = this->nOriginalClauses - result.size();
+        this->clauses->swap(result);
+        return this->maxVarIndex;
+    }
+
+    unsigned getNumAddedVars() const {
+        return this->nAddedVars;
+    }
+
+    /// Net reduction of the number of clauses
+    size_t getNumRemovedClauses() const {
+        return this->nRemovedClauses;
+    }
+
+    unsigned long getWork() const {
+        return this->work;
+    }
+
+private:
+
+    /// Clauses removed by replacing |L| * |R| clauses with |L| + |R| ones
+    static long reduction(size_t nLits, size_t nClauses) {
+        return static_cast<long>(nLits * nClauses) - static_cast<long>(nLits + nClauses);
+    }
+
+    static size_t slot(int lit) {
+        return 2 * std::abs(lit) + (lit < 0);
+    }
+
+    /**
+     * @brief Grow @c lits one literal at a time. Each clause of @c matched
+     *        holds @c l, and with @c l replaced by any literal of @c lits
+     *        it is a clause too.
+     */
+    void extend(int l, std::vector<int> &lits, std::vector<size_t> &matched) {
+
+        while (true) {
+
+            // Candidate literal -> the clauses of matched it completes
+            std::unordered_map<int, std::vector<size_t> > partners;
+            for (size_t id : matched) {
+                const clause_t &C = this->store[id];
+                // Partners hold every other literal of C, so scan the rarest
+                int rarest = 0;
+                for (int lit : C)
+                    if (lit != l && (rarest == 0 || this->counts[slot(lit)] < this->counts[slot(rarest)]))
+                        rarest = lit;
+                for (size_t other : this->occurrences[slot(rarest)]) {
+                    const clause_t &D = this->store[other];
+                    if (!this->alive[other] || other == id || D.size() != C.size())
+                        continue;
+                    this->work += D.size();
+                    int candidate = this->differ(C, D, l);
+                    if (candidate != 0 && candidate != -l &&
+                        std::find(lits.begin(), lits.end(), candidate) == lits.end())
+                        partners[candidate].push_back(id);
+                }
+            }
+
+            int best = 0;
+            for (const auto &partner : partners) {
+                size_t size = partner.second.size(), best_size = best ? partners[best].size() : 0UL;
+                if (size > best_size || (size == best_size && partner.first < best))
+                    best = partner.first;
+            }
+            if (best == 0 || reduction(lits.size() + 1, partners[best].size()) <=
+                             reduction(lits.size(), matched.size()))
+                return;
+            lits.push_back(best);
+            matched.swap(partners[best]);
+        }
+    }
+
+    /// @return The literal of D in place of @c l in C if the clauses are
+    ///         equal otherwise, or 0
+    static int differ(const clause_t &C, const clause_t &D, int l) {
+        int extra = 0;
+        size_t i = 0, j = 0;
+        while (i < C.size() || j < D.size()) {
+            if (j == D.size() || (i < C.size() && C[i] < D[j])) {
+                if (C[i] != l)
+                    return 0;
+                ++i;
+            }
+            else if (i == C.size() || D[j] < C[i]) {
+                if (extra != 0)
+                    return 0;
+                extra = D[j++];
+            }
+            else
+                ++i, ++j;
+        }
+        return extra;
+    }
+
+    void replace(int l, const std::vector<int> &lits, const std::vector<size_t> &matched) {
+
+        int x = ++this->maxVarIndex;
+        this->nAddedVars++;
+        this->occurrences.resize(2 * (x + 1));
+        this->counts.resize(2 * (x + 1), 0UL);
+
+        std::vector<clause_t> rests;
+        for (size_t id : matched) {
+            clause_t rest = this->store[id];
+            rest.erase(std::find(rest.begin(), rest.end(), l));
+            rests.push_back(rest);
+        }
+        for (int lit : lits) {
+            for (const auto &rest : rests) {
+                clause_t D = rest;
+                D.insert(std::upper_bound(D.begin(), D.end(), lit), lit);
+                this->erase(this->index.at(D));
+            }
+        }
+
+        for (int lit : lits)
+            this->add({std::min(lit, x), std::max(lit, x)});
+        for (auto &rest : rests) {
+            rest.insert(rest.begin(), -x);
+            this->add(rest);
+        }
+    }
+
+    void insert(size_t id) {
+        this->index.emplace(this->store[id], id);
+        for (int lit : this->store[id]) {
+            this->occurrences[slot(lit)].push_back(id);
+            this->counts[slot(lit)]++;
+        }
+    }
+
+    /// Occurrence lists drop dead clauses lazily
+    void erase(size_t id) {
+        this->alive[id] = false;
+        this->index.erase(this->store[id]);
+        for (int lit : this->store[id])
+            this->counts[slot(lit)]--;
+    }
+
+    /// @param clause Sorted
+    void add(const clause_t &clause) {
+        if (this->index.count(clause))
+            return;
+        this->store.push_back(clause);
+        this->alive.push_back(true);
+        this->insert(this->store.size() - 1);
+    }
+
+    struct ClauseHash {
+        size_t operator()(const clause_t &clause) const {
+            uint64_t hash = 14695981039346656037ULL;
+            for (int lit : clause)
+                hash = (hash ^ static_cast<uint32_t>(lit)) * 1099511628211ULL;
+            return hash;
+        }
+    };
+
+    std::vector<clause_t> *clauses;
+    int maxVarIndex;
+    size_t nOriginalClauses;
+    /// Sorted copies of the clauses, followed by the added ones
+    std::vector<clause_t> store;
+    std::vector<bool> alive;
+    /// Sorted literals of every live eligible clause to its position
+    std::unordered_map<clause_t, size_t, ClauseHash> index;
+    /// Indexed by @c slot of a literal
+    std::vector<std::vector<size_t> > occurrences;
+    std::vector<size_t> counts;
+    unsigned nAddedVars;
+    size_t nRemovedClauses;
+    unsigned long work;
+
+};
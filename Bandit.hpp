@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "variable_selection.hpp"
+
+/// Conflicts between two choices of the deciding arm
+#define BANDIT_EPOCH 256UL
+
+/**
+ * @brief Multi-armed bandit over branching heuristics [Auer et al., 2002]
+ *
+ *        Every arm sees every search event, so its scores stay current
+ *        while another arm decides. Every BANDIT_EPOCH conflicts the
+ *        deciding arm is rewarded by the conflicts per decision of the
+ *        epoch that ended, and the arm with the highest upper confidence
+ *        bound (UCB1) decides the next epoch. Arms which never ran are 
+ *        tried first. Epochs do not wait for restarts, which are too rare
+ *        to tell the arms apart and skip conflicts with long learned
+ *        clauses.
+ */
+class Bandit : public branching_heuristic {
+
+public:
+
+    /// Takes ownership of @c arms
+    explicit Bandit(const std::vector<branching_heuristic *> &arms) {
+        this->arms = arms;
+        this->pulls.resize(arms.size(), 0U);
+        this->rewards.resize(arms.size(), 0.0);
+        this->current = 0;
+        this->pulls[0] = 1U;
+        this->nDecisions = this->nConflicts = 0UL;
+    }
+
+    virtual ~Bandit() {
+        for (auto arm : this->arms)
+            delete arm;
+    }
+
+    virtual int getNextDicisionVariable() const override {
+        this->nDecisions++;
+        return this->arms[this->current]->getNextDicisionVariable();
+    }
+
+    virtual void update(const clause_t &clause) override {
+        for (auto arm : this->arms)
+            arm->update(clause);
+    }
+
+    virtual void onAssign(int var) override {
+        for (auto arm : this->arms)
+            arm->onAssign(var);
+    }
+
+    virtual void onUnassign(int var) override {
+        for (auto arm : this->arms)
+            arm->onUnassign(var);
+    }
+
+    virtual void onConflict(const std::vector<int> &participants) override {
+        for (auto arm : this->arms)
+            arm->onConflict(participants);
+        if (++this->nConflicts == BANDIT_EPOCH)
+            this->pull();
+    }
+
+    virtual void onRestart() override {
+        for (auto arm : this->arms)
+            arm->onRestart();
+    }
+
+    /// Epochs each arm decided
+    const std::vector<unsigned> &getPulls() const {
+        return this->pulls;
+    }
+
+private:
+
+    /// Reward the deciding arm for the epoch that ended and choose the next
+    void pull() {
+
+        double reward = (this->nDecisions == 0UL) ? 0.0 :
+                        std::min(1.0, static_cast<double>(this->nConflicts) / this->nDecisions);
+        this->rewards[this->current] += reward;
+        this->nDecisions = this->nConflicts = 0UL;
+
+        unsigned total = 0U;
+        for (unsigned n : this->pulls)
+            total += n;
+        double best = -1.0;
+        for (size_t arm = 0; arm < this->arms.size(); ++arm) {
+            double bound = (this->pulls[arm] == 0U) ? 2.0 :
+                           this->rewards[arm] / this->pulls[arm] +
+                           std::sqrt(2.0 * std::log(total) / this->pulls[arm]);
+            if (bound > best) {
+                best = bound;
+                this->current = arm;
+            }
+        }
+        this->pulls[this->current]++;
+    }
+
+    std::vector<branching_heuristic *> arms;
+    std::vector<unsigned> pulls;
+    std::vector<double> rewards;
+    size_t current;
+    /// Of the current epoch; decisions are counted through the const
+    /// interface
+    mutable unsigned long nDecisions;
+    unsigned long nConflicts;
+
+};
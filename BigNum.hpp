@@ -0,0 +1,125 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @brief Unsigned integer of arbitrary precision, as model counts grow
+ *        up to 2^n. Limbs are 32-bit and little-endian, without leading
+ *        zero limbs, so zero has none.
+ */
+class BigNum {
+
+public:
+
+    BigNum(uint64_t value=0ULL) {
+        while (value != 0ULL) {
+            this->limbs.push_back(static_cast<uint32_t>(value));
+            value >>= 32;
+        }
+    }
+
+    bool isZero() const {
+        return this->limbs.empty();
+    }
+
+    /// Number of limbs, which bounds its memory
+    size_t size() const {
+        return this->limbs.size();
+    }
+
+    BigNum &operator+=(const BigNum &other) {
+        if (this->limbs.size() < other.limbs.size())
+            this->limbs.resize(other.limbs.size(), 0U);
+        uint64_t carry = 0ULL;
+        for (size_t i = 0; i < this->limbs.size(); ++i) {
+            uint64_t sum = carry + this->limbs[i] + (i < other.limbs.size() ? other.limbs[i] : 0U);
+            this->limbs[i] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+            if (carry == 0ULL && i >= other.limbs.size())
+                break;
+        }
+        if (carry != 0ULL)
+            this->limbs.push_back(static_cast<uint32_t>(carry));
+        return *this;
+    }
+
+    BigNum operator*(const BigNum &other) const {
+        BigNum product;
+        if (this->isZero() || other.isZero())
+            return product;
+        product.limbs.resize(this->limbs.size() + other.limbs.size(), 0U);
+        for (size_t i = 0; i < this->limbs.size(); ++i) {
+            uint64_t carry = 0ULL;
+            for (size_t j = 0; j < other.limbs.size(); ++j) {
+                uint64_t cell = static_cast<uint64_t>(this->limbs[i]) * other.limbs[j] +
+                                product.limbs[i + j] + carry;
+                product.limbs[i + j] = static_cast<uint32_t>(cell);
+                carry = cell >> 32;
+            }
+            product.limbs[i + other.limbs.size()] = static_cast<uint32_t>(carry);
+        }
+        product.trim();
+        return product;
+    }
+
+    /// Multiply by 2^bits
+    BigNum &operator<<=(size_t bits) {
+        if (this->isZero() || bits == 0UL)
+            return *this;
+        this->limbs.insert(this->limbs.begin(), bits / 32, 0U);
+        bits %= 32;
+        if (bits != 0UL) {
+            uint32_t carry = 0U;
+            for (auto &limb : this->limbs) {
+                uint32_t next = limb >> (32 - bits);
+                limb = (limb << bits) | carry;
+                carry = next;
+            }
+            if (carry != 0U)
+                this->limbs.push_back(carry);
+        }
+        return *this;
+    }
+
+    bool operator==(const BigNum &other) const {
+        return this->limbs == other.limbs;
+    }
+
+    /// Decimal digits
+    std::string toString() const {
+        if (this->isZero())
+            return "0";
+        std::vector<uint32_t> quotient = this->limbs;
+        std::string digits;
+        // Peel off nine digits at a time
+        while (!quotient.empty()) {
+            uint64_t remainder = 0ULL;
+            for (size_t i = quotient.size(); i-- > 0; ) {
+                uint64_t cell = (remainder << 32) | quotient[i];
+                quotient[i] = static_cast<uint32_t>(cell / 1000000000ULL);
+                remainder = cell % 1000000000ULL;
+            }
+            while (!quotient.empty() && quotient.back() == 0U)
+                quotient.pop_back();
+            for (int i = 0; i < 9 && (remainder != 0ULL || !quotient.empty()); ++i) {
+                digits.push_back('0' + remainder % 10ULL);
+                remainder /= 10ULL;
+            }
+        }
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+private:
+
+    void trim() {
+        while (!this->limbs.empty() && this->limbs.back() == 0U)
+            this->limbs.pop_back();
+    }
+
+    std::vector<uint32_t> limbs;
+
+};
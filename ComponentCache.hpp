@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "BigNum.hpp"
+
+/// Per-entry bookkeeping of the hash table, in bytes, on top of the key
+/// and the count
+#define CACHE_ENTRY_OVERHEAD 64UL
+
+/**
+ * @brief Model counts of residual components, keyed by the sorted
+ *        variables and the sorted input clause indices of the component,
+ *        which together determine its residual formula. The whole cache
+ *        is flushed once it would exceed its memory budget.
+ */
+class ComponentCache {
+
+public:
+
+    explicit ComponentCache(size_t budget_bytes) :
+        budget(budget_bytes), used(0UL), nHits(0UL), nMisses(0UL), nFlushes(0UL) {}
+
+    /// @return The cached count, or nullptr
+    const BigNum *lookup(const std::vector<uint32_t> &key) {
+        auto found = this->table.find(key);
+        if (found == this->table.end()) {
+            this->nMisses++;
+            return nullptr;
+        }
+        this->nHits++;
+        return &found->second;
+    }
+
+    void store(const std::vector<uint32_t> &key, const BigNum &count) {
+        size_t bytes = CACHE_ENTRY_OVERHEAD + sizeof(uint32_t) * (key.size() + count.size());
+        if (bytes > this->budget)
+            return;
+        if (this->used + bytes > this->budget) {
+            this->table.clear();
+            this->used = 0UL;
+            this->nFlushes++;
+        }
+        if (this->table.emplace(key, count).second)
+            this->used += bytes;
+    }
+
+    unsigned long getHits() const {
+        return this->nHits;
+    }
+
+    unsigned long getMisses() const {
+        return this->nMisses;
+    }
+
+    unsigned long getFlushes() const {
+        return this->nFlushes;
+    }
+
+private:
+
+    struct KeyHash {
+        size_t operator()(const std::vector<uint32_t> &key) const {
+            uint64_t hash = 14695981039346656037ULL;
+            for (uint32_t word : key)
+                hash = (hash ^ word) * 1099511628211ULL;
+            return hash;
+        }
+    };
+
+    std::unordered_map<std::vector<uint32_t>, BigNum, KeyHash> table;
+    size_t budget;
+    size_t used;
+    unsigned long nHits;
+    unsigned long nMisses;
+    unsigned long nFlushes;
+
+};
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+
+typedef std::vector<int> clause_t;
+
+#define MAX_XOR_SIZE 6U
+
+/// Constraint x_1 ^ x_2 ^ ... ^ x_k = rhs on the variables x_i
+struct xor_t {
+    std::vector<int> vars;
+    bool rhs;
+};
+
+/**
+ * @brief Gauss-Jordan elimination on XOR constraints. Rows are packed
+ *        into 64-bit words, so adding one row to another costs a few
+ *        word operations per 64 columns. The eliminated system is kept
+ *        across calls and only the rows holding a column are updated
+ *        when its variable is assigned or unassigned.
+ */
+class Gauss {
+
+public:
+
+    /**
+     * @brief Recognize XOR constraints encoded directly in CNF, that is
+     *        all 2^(k-1) clauses over the same k variables forbidding
+     *        the assignments of the wrong parity
+     */
+    static std::vector<xor_t> detectXORs(const std::vector<clause_t> &clauses) {
+
+        // Key is the sorted variables of a clause and value is the
+        // set of negated positions of each clause over them
+        std::map<std::vector<int>, std::vector<unsigned> > patterns;
+        for (const auto &clause : clauses) {
+            if (clause.size() < 2 || clause.size() > MAX_XOR_SIZE)
+                continue;
+            clause_t lits = clause;
+            std::sort(lits.begin(), lits.end(), [](int a, int b) {
+                return std::abs(a) < std::abs(b);
+            });
+            std::vector<int> vars;
+            unsigned negated = 0U;
+            for (size_t i = 0; i < lits.size(); ++i) {
+                if (i > 0 && std::abs(lits[i]) == std::abs(lits[i - 1]))
+                    break;
+                vars.push_back(std::abs(lits[i]));
+                if (lits[i] < 0)
+                    negated |= 1U << i;
+            }
+            if (vars.size() == lits.size())
+                patterns[vars].push_back(negated);
+        }
+
+        std::vector<xor_t> xors;
+        for (auto &pattern : patterns) {
+            auto &negated = pattern.second;
+            std::sort(negated.begin(), negated.end());
+            negated.erase(std::unique(negated.begin(), negated.end()), negated.end());
+            unsigned count[2] = {0U, 0U};
+            for (unsigned mask : negated)
+                count[__builtin_parity(mask)]++;
+            unsigned required = 1U << (pattern.first.size() - 1);
+            // A clause with an even number of negations forbids an
+            // assignment of even parity
+            for (int parity = 0; parity < 2; ++parity)
+                if (count[parity] == required)
+                    xors.push_back({pattern.first, parity == 0});
+        }
+        return xors;
+    }
+
+    Gauss(const std::vector<xor_t> &xors, int maxVarIndex) {
+
+        this->var_to_col.resize(maxVarIndex + 1, -1);
+        for (const auto &x : xors)
+            for (int var : x.vars)
+                this->var_to_col[var] = 0;
+        for (int var = 1; var <= maxVarIndex; ++var) {
+            if (this->var_to_col[var] < 0)
+                continue;
+            this->var_to_col[var] = this->col_to_var.size();
+            this->col_to_var.push_back(var);
+        }
+
+        this->nCols = this->col_to_var.size();
+        this->nWords = (this->nCols + 63) / 64;
+        this->nRows = xors.size();
+        this->matrix.resize(this->nRows * this->nWords, 0ULL);
+        this->rhs.resize(this->nRows);
+        for (size_t r = 0; r < this->nRows; ++r) {
+            for (int var : xors[r].vars) {
+                unsigned col = this->var_to_col[var];
+                this->row(r)[col / 64] ^= 1ULL << (col % 64);
+            }
+            this->rhs[r] = xors[r].rhs;
+        }
+        this->assigned.resize(this->nWords, 0ULL);
+        this->values.resize(this->nWords, 0ULL);
+        this->pivot_of_row.resize(this->nRows, -1);
+        this->row_of_pivot.resize(this->nCols, -1);
+        for (size_t r = 0; r < this->nRows; ++r)
+            this->no_pivot.push_back(r);
+
+        // Reduced row echelon form of the whole system, which the
+        // assignments update from then on
+        for (size_t col = 0; col < this->nCols; ++col)
+            this->pivotFree(col);
+        this->changed = true;
+        this->nPropagations = 0UL;
+    }
+
+    size_t getNumRows() const {
+        return this->nRows;
+    }
+
+    size_t getNumColumns() const {
+        return this->nCols;
+    }
+
+    /**
+     * @brief Assign the column of @c lit. If it was the pivot of a row,
+     *        another unassigned column of that row takes over.
+     */
+    void assign(int lit) {
+
+        int col = this->var_to_col[std::abs(lit)];
+        if (col < 0)
+            return;
+        size_t w = col / 64;
+        uint64_t bit = 1ULL << (col % 64);
+        if (this->assigned[w] & bit) {
+            if (static_cast<bool>(this->values[w] & bit) == (lit > 0))
+                return;
+            this->unassign(lit);
+        }
+        this->assigned[w] |= bit;
+        if (lit > 0)
+            this->values[w] |= bit;
+        this->changed = true;
+
+        int p = this->row_of_pivot[col];
+        if (p < 0)
+            return;
+        this->row_of_pivot[col] = -1;
+        const uint64_t *q = this->row(p);
+        for (size_t k = 0; k < this->nWords; ++k) {
+            uint64_t free = q[k] & ~this->assigned[k];
+            if (free) {
+                this->pivot(p, 64 * k + __builtin_ctzll(free));
+                return;
+            }
+        }
+        this->pivot_of_row[p] = -1;
+        this->no_pivot.push_back(p);
+    }
+
+    /**
+     * @brief Unassign the column of @c lit. A row without pivot, all of
+     *        whose columns were assigned, takes it as its pivot.
+     */
+    void unassign(int lit) {
+
+        int col = this->var_to_col[std::abs(lit)];
+        if (col < 0)
+            return;
+        size_t w = col / 64;
+        uint64_t bit = 1ULL << (col % 64);
+        if (!(this->assigned[w] & bit))
+            return;
+        this->assigned[w] &= ~bit;
+        this->values[w] &= ~bit;
+        this->changed = true;
+        this->pivotFree(col);
+    }
+
+    /**
+     * @brief Find the rows left with one or no unassigned column
+     * @param[out] implied Implied literals, each with the clause
+     *             explaining it (the implied literal comes first)
+     * @param[out] conflict The falsified clause if the system is UNSAT
+     * @return false on conflict
+     */
+    bool propagate(std::vector<clause_t> &implied, clause_t &conflict) {
+
+        // Already known to imply nothing
+        if (!this->changed)
+            return true;
+        this->nPropagations++;
+
+        for (size_t r = 0; r < this->nRows; ++r) {
+            const uint64_t *q = this->row(r);
+            int nUnassigned = 0;
+            size_t unassigned_col = 0;
+            for (size_t w = 0; w < this->nWords && nUnassigned < 2; ++w) {
+                uint64_t free = q[w] & ~this->assigned[w];
+                if (free) {
+                    nUnassigned += __builtin_popcountll(free);
+                    unassigned_col = 64 * w + __builtin_ctzll(free);
+                }
+            }
+            if (nUnassigned >= 2)
+                continue;
+            // Assigned columns are moved to the right hand side
+            bool parity = this->rhs[r];
+            for (size_t w = 0; w < this->nWords; ++w)
+                parity ^= __builtin_parityll(q[w] & this->values[w]);
+            if (nUnassigned == 0 && parity) {
+                conflict = this->explain(r, this->nCols, 0);
+                return false;
+            }
+            if (nUnassigned == 1) {
+                int var = this->col_to_var[unassigned_col];
+                implied.push_back(this->explain(r, unassigned_col, parity ? var : -var));
+            }
+        }
+        this->changed = !implied.empty();
+        return true;
+    }
+
+    unsigned long getPropagations() const {
+        return this->nPropagations;
+    }
+
+private:
+
+    inline uint64_t *row(size_t r) {
+        return this->matrix.data() + r * this->nWords;
+    }
+
+    inline const uint64_t *row(size_t r) const {
+        return this->matrix.data() + r * this->nWords;
+    }
+
+    /**
+     * @brief Make the unassigned column @c col the pivot of row @c p and
+     *        eliminate it from every other row. No other row loses its 
+     *        pivot, since pivot columns occur in their own row only.
+     */
+    void pivot(size_t p, size_t col) {
+
+        this->pivot_of_row[p] = col;
+        this->row_of_pivot[col] = p;
+        size_t w = col / 64;
+        uint64_t bit = 1ULL << (col % 64);
+        const uint64_t *q = this->row(p);
+        for (size_t r = 0; r < this->nRows; ++r) {
+            if (r == p || !(this->row(r)[w] & bit))
+                continue;
+            uint64_t *s = this->row(r);
+            for (size_t k = 0; k < this->nWords; ++k)
+                s[k] ^= q[k];
+            this->rhs[r] ^= this->rhs[p];
+        }
+    }
+
+    /// Pivot on the unassigned column @c col a row without pivot
+    /// holding it, if any
+    void pivotFree(size_t col) {
+        size_t w = col / 64;
+        uint64_t bit = 1ULL << (col % 64);
+        for (size_t i = 0; i < this->no_pivot.size(); ++i) {
+            size_t r = this->no_pivot[i];
+            if (this->row(r)[w] & bit) {
+                this->no_pivot[i] = this->no_pivot.back();
+                this->no_pivot.pop_back();
+                this->pivot(r, col);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Build the clause which the combined row @c r of the original
+     *        system implies under the current assignment
+     * @param[in] implied_col Column of the implied variable (or nCols)
+     * @param[in] implied_lit The implied literal, put in front (or 0)
+     */
+    clause_t explain(size_t r, size_t implied_col, int implied_lit) const {
+        clause_t clause;
+        if (implied_lit != 0)
+            clause.push_back(implied_lit);
+        const uint64_t *q = this->row(r);
+        for (size_t w = 0; w < this->nWords; ++w)
+            for (uint64_t bits = q[w]; bits; bits &= bits - 1) {
+                size_t col = 64 * w + __builtin_ctzll(bits);
+                if (col == implied_col)
+                    continue;
+                int var = this->col_to_var[col];
+                clause.push_back((this->values[w] >> (col % 64)) & 1ULL ? -var : var);
+            }
+        return clause;
+    }
+
+    /// Column of every variable, or -1 if it is in no XOR constraint
+    std::vector<int> var_to_col;
+    std::vector<int> col_to_var;
+    size_t nRows;
+    size_t nCols;
+    size_t nWords;
+    /// Each row is a sum of original rows over all columns, so it explains
+    /// itself. Restricted to the unassigned columns, the rows are in 
+    /// reduced row echelon form and rows without pivot are empty.
+    std::vector<uint64_t> matrix;
+    std::vector<char> rhs;
+    std::vector<int> pivot_of_row, row_of_pivot;
+    std::vector<size_t> no_pivot;
+    std::vector<uint64_t> assigned, values;
+    /// Whether a column was assigned or unassigned since the last
+    /// propagation which implied nothing
+    bool changed;
+    unsigned long nPropagations;
+
+};
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include "variable_selection.hpp"
+
+/// Step size of the exponential moving average, which decays per conflict
+#define LRB_ALPHA 0.4
+#define LRB_ALPHA_MIN 0.06
+#define LRB_ALPHA_DECAY 1e-6
+
+/**
+ * @brief Branching Heuristics - Learning Rate Based [Liang et al., 2016]
+ *
+ *        While a variable is assigned, it is rewarded by the fraction of
+ *        conflicts it took part in, and its priority is the exponential
+ *        moving average of these rewards. The variable with the highest
+ *        priority is decided on its saved phase.
+ */
+class LRB : public branching_heuristic {
+
+public:
+
+    LRB() = default;
+
+    LRB(int maxVarIndex, const std::vector<int> *assignments) {
+
+        this->assignments = assignments;
+        this->alpha = LRB_ALPHA;
+        this->nLearned = 0UL;
+        this->priorities.resize(maxVarIndex + 1, 0.0);
+        this->assigned_at.resize(maxVarIndex + 1, 0UL);
+        this->participated.resize(maxVarIndex + 1, 0UL);
+        this->last_conflict.resize(maxVarIndex + 1, 0UL);
+        this->phases.resize(maxVarIndex + 1, false);
+        this->positions.resize(maxVarIndex + 1, -1);
+        for (int var = 1; var <= maxVarIndex; ++var)
+            this->push(var);
+    }
+
+    /**
+     * @brief Branching Heuristics - Learning Rate Based
+     * @return The variable @c x which will be assigned to 1
+     *         (if it's bigger than 0) or 0 instead
+     */
+    virtual int getNextDicisionVariable() const override {
+        // Assigned variables leave the heap lazily
+        while (!this->heap.empty() && this->assignments->at(this->heap[0]) != UNASSIGNED)
+            this->pop();
+        if (this->heap.empty())
+            return 0;
+        int var = this->heap[0];
+        return this->phases[var] ? var : -var;
+    }
+
+    /// The learned clause itself is not rewarded, only the conflict
+    virtual void update(const clause_t &clause) override {}
+
+    virtual void onAssign(int var) override {
+        var = std::abs(var);
+        this->assigned_at[var] = this->nLearned;
+        this->participated[var] = 0UL;
+    }
+
+    virtual void onUnassign(int var) override {
+        this->phases[std::abs(var)] = var > 0;
+        var = std::abs(var);
+        unsigned long interval = this->nLearned - this->assigned_at[var];
+        if (interval > 0UL) {
+            double reward = static_cast<double>(this->participated[var]) / interval;
+            this->priorities[var] = (1.0 - this->alpha) * this->priorities[var] + this->alpha * reward;
+        }
+        if (this->positions[var] < 0)
+            this->push(var);
+        else {
+            this->up(this->positions[var]);
+            this->down(this->positions[var]);
+        }
+    }
+
+    virtual void onConflict(const std::vector<int> &participants) override {
+        this->nLearned++;
+        for (int var : participants) {
+            var = std::abs(var);
+            if (this->last_conflict[var] != this->nLearned) {
+                this->last_conflict[var] = this->nLearned;
+                this->participated[var]++;
+            }
+        }
+        this->alpha = std::max(LRB_ALPHA_MIN, this->alpha - LRB_ALPHA_DECAY);
+    }
+
+private:
+
+    /// Binary max-heap of variables by priority, with the position of
+    /// each variable in it (-1 if absent)
+    void push(int var) const {
+        this->positions[var] = this->heap.size();
+        this->heap.push_back(var);
+        this->up(this->heap.size() - 1);
+    }
+
+    void pop() const {
+        this->positions[this->heap[0]] = -1;
+        this->heap[0] = this->heap.back();
+        this->heap.pop_back();
+        if (!this->heap.empty()) {
+            this->positions[this->heap[0]] = 0;
+            this->down(0);
+        }
+    }
+
+    void up(int i) const {
+        int var = this->heap[i];
+        while (i > 0 && this->priorities[this->heap[(i - 1) / 2]] < this->priorities[var]) {
+            this->heap[i] = this->heap[(i - 1) / 2];
+            this->positions[this->heap[i]] = i;
+            i = (i - 1) / 2;
+        }
+        this->heap[i] = var;
+        this->positions[var] = i;
+    }
+
+    void down(int i) const {
+        int var = this->heap[i], size = this->heap.size();
+        while (2 * i + 1 < size) {
+            int child = 2 * i + 1;
+            if (child + 1 < size && this->priorities[this->heap[child + 1]] > this->priorities[this->heap[child]])
+                child++;
+            if (this->priorities[this->heap[child]] <= this->priorities[var])
+                break;
+            this->heap[i] = this->heap[child];
+            this->positions[this->heap[i]] = i;
+            i = child;
+        }
+        this->heap[i] = var;
+        this->positions[var] = i;
+    }
+
+    const std::vector<int> *assignments;
+    double alpha;
+    /// Conflicts so far, the clock of the rewards
+    unsigned long nLearned;
+    std::vector<double> priorities;
+    std::vector<unsigned long> assigned_at;
+    std::vector<unsigned long> participated;
+    std::vector<unsigned long> last_conflict;
+    /// Saved phases, true for positive
+    std::vector<bool> phases;
+    /// Decisions pop assigned variables through the const interface
+    mutable std::vector<int> heap;
+    mutable std::vector<int> positions;
+
+};
@@ -0,0 +1,419 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include "variable_selection.hpp"
+
+/// Variables whose both polarities are looked ahead on per decision
+#define LOOKAHEAD_CANDIDATES 16U
+/// Variables tried on the second level of a double lookahead
+#define DOUBLE_LOOKAHEAD_CANDIDATES 8U
+/// The double lookahead trigger decays by this factor per decision, so it
+/// keeps being tried
+#define DOUBLE_LOOKAHEAD_DECAY 0.9
+/// Weight of a clause reduced to k free literals, 5^-(k - 2); longer
+/// clauses count as not reduced
+#define REDUCTION_WEIGHTS 7
+static const double reduction_weights[REDUCTION_WEIGHTS] = {0.0, 0.0, 1.0, 0.2, 0.04, 0.008, 0.0016};
+
+/**
+ * @brief Branching Heuristics - Lookahead [Heule and van Maaren, march]
+ *
+ *        The most occurring variables are pre-selected, and both of their
+ *        literals are propagated on a private copy of the assignment. The
+ *        variable whose two sides reduce the most clauses is chosen, on the
+ *        side which reduces less. A literal whose propagation fails is
+ *        returned negated, which the solver takes as an ordinary decision,
+ *        so the failure is only learned if the decision then conflicts.
+ *
+ *        Propagations are shared along binary implications: if a implies
+ *        b, a is looked ahead on top of the assignment of b instead of
+ *        from scratch, and a fails whenever b does. Literals that reduce
+ *        many clauses are also tested on a second level, which finds
+ *        literals failing only by double lookahead.
+ */
+class Lookahead : public branching_heuristic {
+
+public:
+
+    Lookahead() = default;
+
+    Lookahead(const std::vector<clause_t> &clauses, int maxVarIndex,
+              const std::vector<int> *assignments) {
+
+        this->maxVarIndex = maxVarIndex;
+        this->assignments = assignments;
+        this->occurrences.resize(2 * (maxVarIndex + 1));
+        this->watches.resize(2 * (maxVarIndex + 1));
+        this->weights.resize(2 * (maxVarIndex + 1), 0.0);
+        this->values.resize(maxVarIndex + 1, UNASSIGNED);
+        this->parent.resize(2 * (maxVarIndex + 1), 0);
+        this->failed.resize(2 * (maxVarIndex + 1), 0);
+        this->reduction.resize(2 * (maxVarIndex + 1), 0.0);
+        this->double_threshold = 0.0;
+        this->stamp = 0U;
+        for (const auto &clause : clauses)
+            this->update(clause);
+    }
+
+    /**
+     * @brief Branching Heuristics - Lookahead
+     * @return The variable @c x which will be assigned to 1
+     *         (if it's bigger than 0) or 0 instead
+     */
+    virtual int getNextDicisionVariable() const override {
+        // Assignments of the solver since the last decision are propagated
+        // through the private watches, which keeps them valid for the
+        // lookahead propagations
+        for (int var : this->pending)
+            if (this->value(var) == TRUE)
+                this->trail.push_back(var);
+        this->pending.clear();
+        int next_var = this->propagateTrail(0UL, true) ? this->select() : 0;
+        // Literals implied by the private clauses only are not unassigned
+        // by the solver, so they are dropped here
+        for (int var : this->trail)
+            if (this->assignments->at(std::abs(var)) == UNASSIGNED)
+                this->values[std::abs(var)] = UNASSIGNED;
+        this->trail.clear();
+        if (next_var != 0)
+            return next_var;
+        // Only if the solver has not propagated all of its clauses
+        for (int var = 1; var <= this->maxVarIndex; ++var)
+            if (this->assignments->at(var) == UNASSIGNED)
+                return var;
+        return 0;
+    }
+
+    virtual void onAssign(int var) override {
+        if (this->value(var) == UNASSIGNED) {
+            this->values[std::abs(var)] = (var > 0) ? TRUE : FALSE;
+            this->pending.push_back(var);
+        }
+    }
+
+    virtual void onUnassign(int var) override {
+        this->values[std::abs(var)] = UNASSIGNED;
+    }
+
+    /// Learned clauses join the private clause database
+    virtual void update(const clause_t &clause) override {
+        this->clauses.push_back(clause);
+        this->clause_stamps.push_back(0U);
+        double weight = std::pow(2, static_cast<int>(-clause.size()));
+        for (int var : clause) {
+            this->occurrences[index(var)].push_back(this->clauses.size() - 1);
+            this->weights[index(var)] += weight;
+        }
+        // Units are propagated by the solver before any decision
+        if (clause.size() >= 2) {
+            this->watches[index(clause[0])].push_back(this->clauses.size() - 1);
+            this->watches[index(clause[1])].push_back(this->clauses.size() - 1);
+        }
+    }
+
+    /**
+     * @brief Split the formula into at most 2^depth cubes by deciding on
+     *        the lookahead variable at each node. Branches refuted by
+     *        propagation are dropped, so no cube at all means UNSAT.
+     * @return The literals of each cube
+     */
+    std::vector<clause_t> cube(int depth) {
+        std::vector<clause_t> cubes;
+        this->backtrack(0UL);
+        for (const auto &clause : this->clauses)
+            if (clause.empty() || (clause.size() == 1 && !this->propagate(clause[0])))
+                return cubes;
+        clause_t prefix;
+        this->split(prefix, depth, cubes);
+        return cubes;
+    }
+
+private:
+
+    static size_t index(int var) {
+        return (var > 0) ? 2 * var : -2 * var + 1;
+    }
+
+    int value(int var) const {
+        int value = this->values[std::abs(var)];
+        if (value == UNASSIGNED)
+            return UNASSIGNED;
+        return ((value == TRUE) == (var > 0)) ? TRUE : FALSE;
+    }
+
+    void assign(int var) const {
+        this->values[std::abs(var)] = (var > 0) ? TRUE : FALSE;
+        this->trail.push_back(var);
+    }
+
+    /// Assign @c var and propagate it by 2-literal watching, keeping the
+    /// assignments on the trail even on a conflict
+    bool propagate(int var) const {
+        if (this->value(var) != UNASSIGNED)
+            return this->value(var) == TRUE;
+        size_t next = this->trail.size();
+        this->assign(var);
+        return this->propagateTrail(next);
+    }
+
+    /// Propagate the assignments on the trail from @c next on. Unless
+    /// @c drain, a conflict stops at once, which is only valid if the
+    /// trail is backtracked before @c next; otherwise every queued literal
+    /// is still visited, so the watches cover the assignments that stay.
+    bool propagateTrail(size_t next, bool drain = false) const {
+        bool conflict = false;
+        while (next < this->trail.size() && (!conflict || drain)) {
+            int falsified = -this->trail[next++];
+            auto &watching = this->watches[index(falsified)];
+            size_t kept = 0;
+            for (size_t w = 0; w < watching.size(); ++w) {
+                size_t i = watching[w];
+                clause_t &clause = this->clauses[i];
+                if (conflict && !drain) {
+                    watching[kept++] = i;
+                    continue;
+                }
+                if (clause[0] == falsified)
+                    std::swap(clause[0], clause[1]);
+                if (this->value(clause[0]) == TRUE) {
+                    watching[kept++] = i;
+                    continue;
+                }
+                size_t k = 2;
+                while (k < clause.size() && this->value(clause[k]) == FALSE)
+                    k++;
+                if (k < clause.size()) {
+                    std::swap(clause[1], clause[k]);
+                    this->watches[index(clause[1])].push_back(i);
+                    continue;
+                }
+                watching[kept++] = i;
+                if (this->value(clause[0]) == FALSE)
+                    conflict = true;
+                else
+                    this->assign(clause[0]);
+            }
+            watching.resize(kept);
+        }
+        return !conflict;
+    }
+
+    void backtrack(size_t size) const {
+        while (this->trail.size() > size) {
+            this->values[std::abs(this->trail.back())] = UNASSIGNED;
+            this->trail.pop_back();
+        }
+    }
+
+    /// Weighted number of clauses the assignments on the trail after
+    /// @c base shrank without satisfying them
+    double reduced(size_t base) const {
+        this->stamp++;
+        double sum = 0.0;
+        for (size_t t = base; t < this->trail.size(); ++t) {
+            for (size_t i : this->occurrences[index(-this->trail[t])]) {
+                if (this->clause_stamps[i] == this->stamp)
+                    continue;
+                this->clause_stamps[i] = this->stamp;
+                int nFree = 0;
+                bool satisfied = false;
+                for (int lit : this->clauses[i]) {
+                    int value = this->value(lit);
+                    if ((satisfied = value == TRUE))
+                        break;
+                    nFree += value == UNASSIGNED;
+                }
+                if (!satisfied && nFree >= 2)
+                    sum += (nFree < REDUCTION_WEIGHTS) ? reduction_weights[nFree] : 0.0;
+            }
+        }
+        return sum;
+    }
+
+    /// Unassigned variables with the largest product of literal weights
+    std::vector<int> preselect(size_t count) const {
+        std::vector<int> free;
+        for (int var = 1; var <= this->maxVarIndex; ++var)
+            if (this->values[var] == UNASSIGNED)
+                free.push_back(var);
+        count = std::min(count, free.size());
+        auto score = [this](int var) {
+            return (this->weights[index(var)] + 1e-9) * (this->weights[index(-var)] + 1e-9);
+        };
+        std::partial_sort(free.begin(), free.begin() + count, free.end(),
+                          [&score](int a, int b) { return score(a) > score(b); });
+        free.resize(count);
+        return free;
+    }
+
+    /// Looks ahead on @c var on top of the current trail, then on the
+    /// literals implying it
+    void visit(int var, size_t base, const std::vector<std::vector<int> > &children) const {
+        size_t mark = this->trail.size();
+        bool ok = !this->failed[index(var)] && this->propagate(var);
+        if (ok) {
+            this->reduction[index(var)] = this->reduced(base);
+            if (this->reduction[index(var)] > this->double_threshold)
+                ok = this->doubleLookahead(var);
+        }
+        this->failed[index(var)] = !ok;
+        for (int child : children[index(var)]) {
+            if (ok)
+                this->visit(child, base, children);
+            else
+                this->failed[index(child)] = 1;
+        }
+        this->backtrack(mark);
+    }
+
+    /// Second level on top of @c var, which fails if both sides of a
+    /// second variable do. Single failures are kept as implied by @c var.
+    bool doubleLookahead(int var) const {
+        bool found = false;
+        size_t count = std::min<size_t>(DOUBLE_LOOKAHEAD_CANDIDATES, this->candidates.size());
+        for (int second : std::vector<int>(this->candidates.begin(), this->candidates.begin() + count)) {
+            if (this->values[second] != UNASSIGNED)
+                continue;
+            size_t mark = this->trail.size();
+            if (this->propagate(second)) {
+                this->backtrack(mark);
+                continue;
+            }
+            this->backtrack(mark);
+            found = true;
+            if (!this->propagate(-second))
+                return false;
+        }
+        // Nothing found, so only look twice on more reducing literals
+        if (!found)
+            this->double_threshold = this->reduction[index(var)];
+        return true;
+    }
+
+    int select() const {
+
+        std::vector<int> candidates = this->preselect(LOOKAHEAD_CANDIDATES);
+        this->candidates = candidates;
+        if (candidates.empty())
+            return 0;
+        this->double_threshold *= DOUBLE_LOOKAHEAD_DECAY;
+
+        std::vector<int> literals;
+        for (int var : candidates) {
+            literals.push_back(var);
+            literals.push_back(-var);
+        }
+        for (int var : literals) {
+            this->parent[index(var)] = 0;
+            this->failed[index(var)] = 0;
+            this->reduction[index(var)] = 0.0;
+        }
+        // Forest of binary implications among candidate literals: a is a
+        // child of b if a clause (-a | b) has no other free literal
+        for (int var : literals) {
+            this->parent[index(var)] = 0;
+            for (size_t i : this->occurrences[index(-var)]) {
+                int implied = 0, nFree = 0;
+                bool satisfied = false;
+                for (int lit : this->clauses[i]) {
+                    int value = this->value(lit);
+                    if ((satisfied = value == TRUE) || nFree > 1)
+                        break;
+                    if (value == UNASSIGNED && lit != -var) {
+                        implied = lit;
+                        nFree++;
+                    }
+                }
+                if (satisfied || nFree != 1 ||
+                    std::find(literals.begin(), literals.end(), implied) == literals.end())
+                    continue;
+                // No cycles, so every tree has a root
+                int ancestor = implied;
+                while (ancestor != 0 && ancestor != var)
+                    ancestor = this->parent[index(ancestor)];
+                if (ancestor == 0) {
+                    this->parent[index(var)] = implied;
+                    break;
+                }
+            }
+        }
+        std::vector<std::vector<int> > children(2 * (this->maxVarIndex + 1));
+        for (int var : literals)
+            if (this->parent[index(var)] != 0)
+                children[index(this->parent[index(var)])].push_back(var);
+
+        size_t base = this->trail.size();
+        for (int var : literals)
+            if (this->parent[index(var)] == 0)
+                this->visit(var, base, children);
+
+        int next_var = 0;
+        double max_score = -1.0;
+        for (int var : candidates) {
+            bool pos_failed = this->failed[index(var)], neg_failed = this->failed[index(-var)];
+            // A failed literal forces its negation
+            if (pos_failed != neg_failed)
+                return pos_failed ? -var : var;
+            if (pos_failed)
+                return var;
+            double pos = this->reduction[index(var)], neg = this->reduction[index(-var)];
+            double score = 1024.0 * pos * neg + pos + neg;
+            if (score > max_score) {
+                max_score = score;
+                next_var = (pos <= neg) ? var : -var;
+            }
+        }
+        return next_var;
+    }
+
+    void split(clause_t &prefix, int depth, std::vector<clause_t> &cubes) {
+        int next_var = (depth > 0) ? this->select() : 0;
+        if (next_var == 0) {
+            cubes.push_back(prefix);
+            return;
+        }
+        for (int var : {next_var, -next_var}) {
+            size_t mark = this->trail.size();
+            if (this->propagate(var)) {
+                prefix.push_back(var);
+                this->split(prefix, depth - 1, cubes);
+                prefix.pop_back();
+            }
+            this->backtrack(mark);
+        }
+    }
+
+    /// Private copy of the clauses, learned ones included, whose first
+    /// two literals are watched, and the clauses each literal occurs in
+    mutable std::vector<clause_t> clauses;
+    mutable std::vector<std::vector<size_t> > watches;
+    std::vector<std::vector<size_t> > occurrences;
+    /// Sum of 2^-|C| over the clauses C each literal occurs in
+    std::vector<double> weights;
+    int maxVarIndex;
+    const std::vector<int> *assignments;
+
+    /// The heuristic is queried through a const interface, but looking
+    /// ahead needs its own assignment to propagate on. It follows the
+    /// assignment of the solver through the hooks, and the trail holds
+    /// what a decision assigns on top.
+    mutable std::vector<int> values;
+    mutable std::vector<int> trail;
+    /// Assigned by the solver, not yet propagated through the watches
+    mutable std::vector<int> pending;
+    mutable std::vector<unsigned> clause_stamps;
+    mutable unsigned stamp;
+    /// Per literal: the literal it implies, whether it failed and how
+    /// much it reduced
+    mutable std::vector<int> parent;
+    mutable std::vector<char> failed;
+    mutable std::vector<double> reduction;
+    /// Pre-selected variables of the current decision, best first
+    mutable std::vector<int> candidates;
+    mutable double double_threshold;
+
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+typedef std::vector<int> clause_t;
+
+#define PROBSAT_CB 2.06
+#define PROBSAT_EPS 0.9
+
+/**
+ * @brief Stochastic local search proposed in [Balint and Schoening, 2012].
+ *        Break counts are maintained incrementally; every clause keeps the
+ *        number of its true literals and the XOR of their variables, so
+ *        the only true variable of a critical clause is read off directly.
+ */
+class ProbSAT {
+
+public:
+
+    /**
+     * @param[in] nClauses Only the first @c nClauses clauses are searched 
+     *            on, e.g. to leave out learned ones
+     */
+    ProbSAT(const std::vector<clause_t> &clauses, int maxVarIndex, uint64_t seed=1,
+            size_t nClauses=SIZE_MAX) {
+
+        this->clauses = &clauses;
+        this->nClauses = std::min(clauses.size(), nClauses);
+        this->maxVarIndex = maxVarIndex;
+        this->rng = seed ? seed : 1;
+        this->nFlips = 0;
+
+        // Occurrence lists in compressed row storage, indexed by literal
+        std::vector<unsigned> count(2 * maxVarIndex + 2, 0);
+        for (size_t i = 0; i < this->nClauses; ++i)
+            for (int var : clauses[i])
+                count[index(var)]++;
+        this->occ_start.resize(2 * maxVarIndex + 3, 0);
+        for (size_t lit = 0; lit < count.size(); ++lit)
+            this->occ_start[lit + 1] = this->occ_start[lit] + count[lit];
+        this->occ.resize(this->occ_start.back());
+        for (size_t i = 0; i < this->nClauses; ++i)
+            for (int var : clauses[i])
+                this->occ[this->occ_start[index(var)] + --count[index(var)]] = i;
+
+        this->nTrue.resize(this->nClauses);
+        this->critical.resize(this->nClauses);
+        this->unsat_pos.resize(this->nClauses);
+        this->values.resize(maxVarIndex + 1, false);
+        this->frozen.resize(maxVarIndex + 1, false);
+        this->breaks.resize(maxVarIndex + 1);
+
+        // Probabilities of the polynomial break-only distribution
+        for (int b = 0; b < 64; ++b)
+            this->probs.push_back(std::pow(PROBSAT_EPS + b, -PROBSAT_CB));
+    }
+
+    /**
+     * @brief Run ProbSAT from the given starting point
+     * @param[in] initial i-th element is the initial value of variable i
+     * @param[in] fixed Variables which must keep their initial value
+     * @param[in] maxFlips Flip budget of this run
+     * @return true if a model was found
+     */
+    bool solve(const std::vector<bool> &initial, const std::vector<bool> &fixed,
+               unsigned long maxFlips) {
+
+        this->values = initial;
+        this->frozen = fixed;
+        this->values.resize(this->maxVarIndex + 1, false);
+        this->frozen.resize(this->maxVarIndex + 1, false);
+        this->initialize();
+
+        this->best = this->values;
+        size_t best_nUnsat = this->unsat.size();
+
+        std::vector<int> candidates;
+        std::vector<double> weights;
+
+        for (unsigned long flip = 0; flip < maxFlips && !this->unsat.empty(); ++flip) {
+
+            const clause_t &clause = (*this->clauses)[this->unsat[random() % this->unsat.size()]];
+
+            candidates.clear();
+            weights.clear();
+            double sum = 0.0;
+            for (int var : clause) {
+                if (this->frozen[std::abs(var)])
+                    continue;
+                int b = this->breaks[std::abs(var)];
+                candidates.push_back(std::abs(var));
+                weights.push_back(b < 64 ? this->probs[b] : std::pow(PROBSAT_EPS + b, -PROBSAT_CB));
+                sum += weights.back();
+            }
+            // Falsified by the fixed variables alone
+            if (candidates.empty())
+                continue;
+
+            double r = sum * (random() >> 11) * (1.0 / 9007199254740992.0);
+            size_t i = 0;
+            while (i + 1 < candidates.size() && (r -= weights[i]) > 0.0)
+                ++i;
+            this->flip(candidates[i]);
+            this->nFlips++;
+
+            if (this->unsat.size() < best_nUnsat) {
+                best_nUnsat = this->unsat.size();
+                this->best = this->values;
+            }
+        }
+        return this->unsat.empty();
+    }
+
+    /// The assignment with the fewest falsified clauses seen in the last run
+    const std::vector<bool> &getBestAssignment() const {
+        return this->best;
+    }
+
+    unsigned long getFlips() const {
+        return this->nFlips;
+    }
+
+private:
+
+    /// Literal x is stored at 2|x| and -x at 2|x|+1
+    static inline size_t index(int var) {
+        return var > 0 ? 2 * var : -2 * var + 1;
+    }
+
+    inline bool isTrue(int var) const {
+        return this->values[std::abs(var)] == (var > 0);
+    }
+
+    /// xorshift64*
+    inline uint64_t random() {
+        this->rng ^= this->rng >> 12;
+        this->rng ^= this->rng << 25;
+        this->rng ^= this->rng >> 27;
+        return this->rng * 2685821657736338717ULL;
+    }
+
+    void initialize() {
+        this->unsat.clear();
+        std::fill(this->breaks.begin(), this->breaks.end(), 0);
+        for (size_t i = 0; i < this->nClauses; ++i) {
+            this->nTrue[i] = 0;
+            this->critical[i] = 0;
+            for (int var : (*this->clauses)[i])
+                if (this->isTrue(var)) {
+                    this->nTrue[i]++;
+                    this->critical[i] ^= std::abs(var);
+                }
+            if (this->nTrue[i] == 0) {
+                this->unsat_pos[i] = this->unsat.size();
+                this->unsat.push_back(i);
+            }
+            else if (this->nTrue[i] == 1)
+                this->breaks[this->critical[i]]++;
+        }
+    }
+
+    void flip(int var) {
+
+        int true_lit = this->values[var] ? var : -var;
+        this->values[var] = !this->values[var];
+
+        // Clauses losing their true literal
+        for (unsigned k = this->occ_start[index(true_lit)]; k < this->occ_start[index(true_lit) + 1]; ++k) {
+            unsigned c = this->occ[k];
+            this->critical[c] ^= var;
+            if (--this->nTrue[c] == 0) {
+                this->breaks[var]--;
+                this->unsat_pos[c] = this->unsat.size();
+                this->unsat.push_back(c);
+            }
+            else if (this->nTrue[c] == 1)
+                this->breaks[this->critical[c]]++;
+        }
+
+        // Clauses gaining a true literal
+        for (unsigned k = this->occ_start[index(-true_lit)]; k < this->occ_start[index(-true_lit) + 1]; ++k) {
+            unsigned c = this->occ[k];
+            this->critical[c] ^= var;
+            if (++this->nTrue[c] == 1) {
+                this->breaks[var]++;
+                unsigned last = this->unsat.back();
+                this->unsat[this->unsat_pos[c]] = last;
+                this->unsat_pos[last] = this->unsat_pos[c];
+                this->unsat.pop_back();
+            }
+            else if (this->nTrue[c] == 2)
+                this->breaks[this->critical[c] ^ var]--;
+        }
+    }
+
+    const std::vector<clause_t> *clauses;
+    size_t nClauses;
+    int maxVarIndex;
+    /// occ[occ_start[index(x)] .. occ_start[index(x) + 1]) are clauses containing x
+    std::vector<unsigned> occ_start;
+    std::vector<unsigned> occ;
+    /// Number of true literals on each clause
+    std::vector<int> nTrue;
+    /// XOR of the true variables on each clause
+    std::vector<int> critical;
+    /// Falsified clauses and their positions in @c unsat
+    std::vector<unsigned> unsat;
+    std::vector<unsigned> unsat_pos;
+    /// Number of clauses which become falsified if the variable is flipped
+    std::vector<int> breaks;
+    std::vector<bool> values;
+    std::vector<bool> frozen;
+    std::vector<bool> best;
+    std::vector<double> probs;
+    uint64_t rng;
+    unsigned long nFlips;
+
+};
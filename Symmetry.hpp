@@ -0,0 +1,321 @@
+#pragma once
+
+#include <set>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+
+typedef std::vector<int> clause_t;
+
+#define SYMMETRY_MAX_VERTICES 200000U
+#define SYMMETRY_WORK_BUDGET 100000000UL
+#define LEX_LEADER_LENGTH 32U
+
+/**
+ * @brief Static symmetry detection. The formula is turned into a graph
+ *        with a vertex per literal and per clause; literal vertices are
+ *        linked to their complement and to the clauses containing them.
+ *        Automorphisms of the graph are searched by individualization
+ *        and refinement along a single path, which yields generators of
+ *        the symmetry group, and are broken by lex-leader predicates
+ *        [Aloul et al., 2006].
+ */
+class Symmetry {
+
+public:
+
+    Symmetry(const std::vector<clause_t> &clauses, int maxVarIndex) {
+
+        this->clauses = &clauses;
+        this->maxVarIndex = maxVarIndex;
+        this->nVertices = 2 * maxVarIndex + clauses.size();
+        this->work = 0UL;
+
+        // Adjacency in compressed row storage
+        std::vector<std::pair<int, int> > edges;
+        for (int var = 1; var <= maxVarIndex; ++var)
+            edges.emplace_back(vertex(var), vertex(-var));
+        for (size_t i = 0; i < clauses.size(); ++i) {
+            std::vector<int> lits = sorted(clauses[i]);
+            for (int lit : lits)
+                edges.emplace_back(vertex(lit), 2 * maxVarIndex + i);
+            this->clause_set.insert(lits);
+        }
+        this->adj_start.resize(this->nVertices + 1, 0);
+        for (const auto &edge : edges) {
+            this->adj_start[edge.first + 1]++;
+            this->adj_start[edge.second + 1]++;
+        }
+        std::partial_sum(this->adj_start.begin(), this->adj_start.end(), this->adj_start.begin());
+        this->adj.resize(this->adj_start.back());
+        std::vector<int> fill(this->adj_start.begin(), this->adj_start.end() - 1);
+        for (const auto &edge : edges) {
+            this->adj[fill[edge.first]++] = edge.second;
+            this->adj[fill[edge.second]++] = edge.first;
+        }
+    }
+
+    /**
+     * @return Generators of the symmetry group found within the search
+     *         budget; i-th element of a generator is the image of literal
+     *         i - maxVarIndex
+     */
+    std::vector<std::vector<int> > findGenerators() {
+
+        std::vector<std::vector<int> > generators;
+        if (this->nVertices > SYMMETRY_MAX_VERTICES || this->maxVarIndex == 0)
+            return generators;
+
+        // Literals and clauses are colored differently
+        std::vector<int> colors(this->nVertices, 0);
+        for (size_t v = 2 * this->maxVarIndex; v < this->nVertices; ++v)
+            colors[v] = 1;
+        int nCells;
+        std::vector<int> path = this->refine(colors, nCells);
+
+        // Orbits of the group generated so far, to skip known images
+        std::vector<int> orbit(this->nVertices);
+        std::iota(orbit.begin(), orbit.end(), 0);
+
+        while (nCells < static_cast<int>(this->nVertices) && this->work < SYMMETRY_WORK_BUDGET) {
+
+            std::vector<int> cell = this->targetCell(path, nCells);
+            int v = cell[0];
+            int nLeft;
+            std::vector<int> left = this->refine(this->individualize(path, v, nCells), nLeft);
+
+            for (size_t i = 1; i < cell.size() && this->work < SYMMETRY_WORK_BUDGET; ++i) {
+                int w = cell[i];
+                if (find(orbit, w) == find(orbit, v))
+                    continue;
+                int nRight;
+                std::vector<int> right = this->refine(this->individualize(path, w, nCells), nRight);
+                std::vector<int> perm;
+                if (nLeft == nRight && this->search(left, right, nLeft, perm)) {
+                    for (size_t u = 0; u < this->nVertices; ++u)
+                        orbit[find(orbit, u)] = find(orbit, perm[u]);
+                    generators.push_back(this->toLiteralPermutation(perm));
+                }
+            }
+
+            path.swap(left);
+            nCells = nLeft;
+        }
+        return generators;
+    }
+
+    /**
+     * @brief Lex-leader symmetry-breaking clauses over the first
+     *        @c LEX_LEADER_LENGTH variables moved by each generator
+     * @param[in,out] maxVarIndex Auxiliary variables are numbered after it
+     */
+    static std::vector<clause_t> lexLeader(const std::vector<std::vector<int> > &generators,
+                                           int &maxVarIndex, int nVars) {
+
+        std::vector<clause_t> sbp;
+        for (const auto &sigma : generators) {
+            // p is true if the prefix so far is equal to its image
+            int p = 0;
+            unsigned length = 0U;
+            for (int x = 1; x <= nVars && length < LEX_LEADER_LENGTH; ++x) {
+                int y = sigma[x + nVars];
+                if (y == x)
+                    continue;
+                length++;
+                clause_t prefix = (p == 0) ? clause_t() : clause_t{-p};
+                // x <= sigma(x) if the prefix is equal
+                clause_t le = prefix;
+                le.push_back(-x);
+                // x is forced to 0 and never equals its complement
+                if (y == -x) {
+                    sbp.push_back(le);
+                    break;
+                }
+                le.push_back(y);
+                sbp.push_back(le);
+                int q = ++maxVarIndex;
+                clause_t eq1 = prefix, eq2 = prefix;
+                eq1.push_back(-x);
+                eq1.push_back(q);
+                eq2.push_back(y);
+                eq2.push_back(q);
+                sbp.push_back(eq1);
+                sbp.push_back(eq2);
+                p = q;
+            }
+        }
+        return sbp;
+    }
+
+    unsigned long getWork() const {
+        return this->work;
+    }
+
+private:
+
+    inline int vertex(int lit) const {
+        return 2 * (std::abs(lit) - 1) + (lit < 0);
+    }
+
+    static std::vector<int> sorted(const clause_t &clause) {
+        std::vector<int> lits = clause;
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+        return lits;
+    }
+
+    static int find(std::vector<int> &parent, int v) {
+        while (parent[v] != v)
+            v = parent[v] = parent[parent[v]];
+        return v;
+    }
+
+    static inline uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Color refinement until the partition is equitable. New colors
+     *        are ranks of (color, hash of neighbor colors), so refining
+     *        isomorphic colorings gives corresponding colors.
+     * @param[out] nCells Number of colors
+     */
+    std::vector<int> refine(std::vector<int> colors, int &nCells) {
+
+        std::vector<std::pair<std::pair<int, uint64_t>, int> > keys(this->nVertices);
+        nCells = -1;
+        while (true) {
+            this->work += this->adj.size() + this->nVertices;
+            for (size_t v = 0; v < this->nVertices; ++v) {
+                uint64_t h = 0;
+                for (int k = this->adj_start[v]; k < this->adj_start[v + 1]; ++k)
+                    h += mix(colors[this->adj[k]]);
+                keys[v] = {{colors[v], h}, static_cast<int>(v)};
+            }
+            std::sort(keys.begin(), keys.end());
+            int count = 0;
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (i > 0 && keys[i].first != keys[i - 1].first)
+                    count++;
+                colors[keys[i].second] = count;
+            }
+            if (count + 1 == nCells)
+                break;
+            nCells = count + 1;
+        }
+        return colors;
+    }
+
+    /// Give @c v a color of its own
+    std::vector<int> individualize(const std::vector<int> &colors, int v, int nCells) const {
+        std::vector<int> result = colors;
+        result[v] = nCells;
+        return result;
+    }
+
+    /// The smallest non-singleton cell, preferring literals
+    std::vector<int> targetCell(const std::vector<int> &colors, int nCells) const {
+        std::vector<int> size(nCells, 0);
+        for (int c : colors)
+            size[c]++;
+        int best = -1;
+        for (size_t v = 0; v < this->nVertices; ++v) {
+            int c = colors[v];
+            if (size[c] > 1 && (best < 0 || size[c] < size[best]))
+                best = c;
+            if (v + 1 == 2U * this->maxVarIndex && best >= 0)
+                break;
+        }
+        std::vector<int> cell;
+        for (size_t v = 0; v < this->nVertices; ++v)
+            if (colors[v] == best)
+                cell.push_back(v);
+        return cell;
+    }
+
+    /**
+     * @brief Extend the correspondence of @c left and @c right colorings
+     *        to an automorphism
+     */
+    bool search(const std::vector<int> &left, const std::vector<int> &right, int nCells,
+                std::vector<int> &perm) {
+
+        std::vector<int> left_size(nCells, 0), right_size(nCells, 0);
+        for (size_t v = 0; v < this->nVertices; ++v) {
+            left_size[left[v]]++;
+            right_size[right[v]]++;
+        }
+        if (left_size != right_size)
+            return false;
+
+        if (nCells == static_cast<int>(this->nVertices)) {
+            std::vector<int> at(this->nVertices);
+            for (size_t v = 0; v < this->nVertices; ++v)
+                at[right[v]] = v;
+            perm.resize(this->nVertices);
+            for (size_t v = 0; v < this->nVertices; ++v)
+                perm[v] = at[left[v]];
+            return this->isAutomorphism(perm);
+        }
+
+        std::vector<int> cell = this->targetCell(left, nCells);
+        int nLeft;
+        std::vector<int> next_left = this->refine(this->individualize(left, cell[0], nCells), nLeft);
+        for (size_t w = 0; w < this->nVertices && this->work < SYMMETRY_WORK_BUDGET; ++w) {
+            if (right[w] != left[cell[0]])
+                continue;
+            int nRight;
+            std::vector<int> next_right = this->refine(this->individualize(right, w, nCells), nRight);
+            if (nLeft == nRight && this->search(next_left, next_right, nLeft, perm))
+                return true;
+        }
+        return false;
+    }
+
+    bool isAutomorphism(const std::vector<int> &perm) const {
+        for (int var = 1; var <= this->maxVarIndex; ++var) {
+            if (perm[vertex(var)] >= 2 * this->maxVarIndex ||
+                (perm[vertex(var)] ^ 1) != perm[vertex(-var)])
+                return false;
+        }
+        std::vector<int> image;
+        for (const auto &lits : this->clause_set) {
+            image.clear();
+            for (int lit : lits)
+                image.push_back(literal(perm[vertex(lit)]));
+            std::sort(image.begin(), image.end());
+            if (!this->clause_set.count(image))
+                return false;
+        }
+        return true;
+    }
+
+    inline int literal(int v) const {
+        return (v & 1) ? -(v / 2 + 1) : v / 2 + 1;
+    }
+
+    std::vector<int> toLiteralPermutation(const std::vector<int> &perm) const {
+        std::vector<int> sigma(2 * this->maxVarIndex + 1, 0);
+        for (int var = 1; var <= this->maxVarIndex; ++var) {
+            sigma[var + this->maxVarIndex] = literal(perm[vertex(var)]);
+            sigma[-var + this->maxVarIndex] = literal(perm[vertex(-var)]);
+        }
+        return sigma;
+    }
+
+    const std::vector<clause_t> *clauses;
+    int maxVarIndex;
+    size_t nVertices;
+    std::vector<int> adj_start;
+    std::vector<int> adj;
+    std::set<std::vector<int> > clause_set;
+    /// Vertices and edges visited by refinement, bounded by @c SYMMETRY_WORK_BUDGET
+    unsigned long work;
+
+};
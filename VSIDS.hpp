@@ -3,6 +3,7 @@
 #include <map>
 #include <list>
 #include <vector>
+#include <cstdint>
 #include <utility>
 #include <iostream>
 
@@ -32,10 +33,26 @@ public:
                     this->scores_reverse[-var].second++;
             }
 
-        for (int var = 1; var <= maxVarIndex; ++var) {
-            this->scores[this->scores_reverse[var].first].push_back(var);
-            this->scores[this->scores_reverse[var].second].push_back(-var);
-        }
+        this->setScores(this->scores_reverse);
+    }
+
+    /**
+     * @brief Start from precomputed occurrence counts instead of scanning 
+     *        the clauses
+     * @param[in] occurrences Number of occurrences of literal x at 
+     *            2 * |x| (positive) or 2 * |x| + 1 (negative)
+     */
+    VSIDS(const int32_t *occurrences, int maxVarIndex, 
+          const std::vector<int> *assignments, const unsigned *nConflicts) {
+
+        this->nConflicts = nConflicts;
+        this->maxVarIndex = maxVarIndex;
+        this->assignments = assignments;
+        this->scores_reverse.resize(maxVarIndex + 1, {0, 0});
+        for (int var = 1; var <= maxVarIndex; ++var)
+            this->scores_reverse[var] = {occurrences[2 * var], occurrences[2 * var + 1]};
+
+        this->setScores(this->scores_reverse);
     }
 
     /**
@@ -69,6 +86,20 @@ public:
             this->decay();
     }
 
+    /// i-th element is pair of positive and negative scores of variable i
+    const std::vector<std::pair<int, int> > &getScores() const {
+        return this->scores_reverse;
+    }
+
+    void setScores(const std::vector<std::pair<int, int> > &scores) {
+        this->scores_reverse = scores;
+        this->scores.clear();
+        for (int var = 1; var <= maxVarIndex; ++var) {
+            this->scores[this->scores_reverse[var].first].push_back(var);
+            this->scores[this->scores_reverse[var].second].push_back(-var);
+        }
+    }
+
     void decay() {
 
 #ifdef DEBUG
@@ -0,0 +1,389 @@
+#include "aiger.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+
+#define AIGER_FALSE 0U
+#define AIGER_TRUE 1U
+#define UNMAPPED UINT32_MAX
+
+/// Polarities in which a gate of the hashed graph is needed
+#define POSITIVE 1
+#define NEGATIVE 2
+
+namespace {
+
+/// Cursor over the file contents
+struct Reader {
+    const std::string &buffer;
+    size_t pos;
+
+    /// Reads the unsigned number which must come next, skipping blanks
+    /// but not newlines
+    bool number(unsigned &value) {
+        while (this->pos < this->buffer.size() && this->buffer[this->pos] == ' ')
+            this->pos++;
+        if (this->pos >= this->buffer.size() || !std::isdigit(this->buffer[this->pos]))
+            return false;
+        unsigned long long parsed = 0ULL;
+        while (this->pos < this->buffer.size() && std::isdigit(this->buffer[this->pos])) {
+            parsed = parsed * 10ULL + (this->buffer[this->pos++] - '0');
+            if (parsed > UINT32_MAX - 1U)
+                return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    /// Skips the rest of the line, which must be blank
+    bool newline() {
+        while (this->pos < this->buffer.size() && this->buffer[this->pos] == ' ')
+            this->pos++;
+        if (this->pos >= this->buffer.size() || this->buffer[this->pos] != '\n')
+            return false;
+        this->pos++;
+        return true;
+    }
+
+    /// Reads a 7-bit little-endian varint of the binary format
+    bool delta(unsigned &value) {
+        unsigned long long parsed = 0ULL;
+        for (unsigned shift = 0U; shift < 35U; shift += 7U) {
+            if (this->pos >= this->buffer.size())
+                return false;
+            unsigned char byte = this->buffer[this->pos++];
+            parsed |= static_cast<unsigned long long>(byte & 0x7fU) << shift;
+            if (!(byte & 0x80U)) {
+                if (parsed > UINT32_MAX)
+                    return false;
+                value = parsed;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}
+
+bool AIGER::read(const char *filename) {
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << filename << "\n";
+        return false;
+    }
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Reader reader{buffer, 3UL};
+
+    bool binary = !buffer.compare(0, 3, "aig");
+    if (!binary && buffer.compare(0, 3, "aag")) {
+        std::cerr << filename << " is not an AIGER file\n";
+        return false;
+    }
+    // M I L O A, optionally followed by B C J F
+    unsigned header[9] = {0U};
+    size_t nFields = 0UL;
+    while (nFields < 9UL && reader.number(header[nFields]))
+        nFields++;
+    if (nFields < 5UL || !reader.newline()) {
+        std::cerr << "Invalid AIGER header\n";
+        return false;
+    }
+    this->maxVar = header[0];
+    this->nInputs = header[1];
+    this->nLatches = header[2];
+    this->nAnds = header[4];
+    unsigned nOutputs = header[3], nBad = header[5], nConstraints = header[6];
+    if (header[7] != 0U || header[8] != 0U) {
+        std::cerr << "Justice and fairness properties are not supported\n";
+        return false;
+    }
+    if (static_cast<unsigned long long>(this->nInputs) + this->nLatches + this->nAnds > this->maxVar ||
+        (binary && this->nInputs + this->nLatches + this->nAnds != this->maxVar)) {
+        std::cerr << "Invalid AIGER header\n";
+        return false;
+    }
+
+    unsigned maxLit = 2U * this->maxVar + 1U;
+    auto literal = [&reader, maxLit](unsigned &lit) {
+        return reader.number(lit) && lit <= maxLit;
+    };
+    auto invalid = [](const char *section) {
+        std::cerr << "Invalid AIGER " << section << "\n";
+        return false;
+    };
+
+    this->ands.assign(this->maxVar + 1, std::make_pair(0U, 0U));
+    // Inputs and latches are free until their definitions are read, which
+    // lets definitions be checked for uniqueness
+    std::vector<char> defined(this->maxVar + 1, 0), gates(this->maxVar + 1, 0);
+    defined[0] = 1;
+
+    std::vector<unsigned> input_vars;
+    for (unsigned i = 0U; i < this->nInputs; ++i) {
+        unsigned lit = 2U * (i + 1U);
+        if (!binary && (!literal(lit) || !reader.newline()))
+            return invalid("input");
+        if ((lit & 1U) || defined[lit / 2])
+            return invalid("input");
+        defined[lit / 2] = 1;
+        input_vars.push_back(lit / 2);
+    }
+
+    this->latches.clear();
+    std::vector<unsigned> latch_vars;
+    for (unsigned i = 0U; i < this->nLatches; ++i) {
+        unsigned lit = 2U * (this->nInputs + i + 1U), next, reset = AIGER_FALSE;
+        if (!binary && !literal(lit))
+            return invalid("latch");
+        if (!literal(next))
+            return invalid("latch");
+        if (reader.number(reset) && reset != AIGER_FALSE && reset != AIGER_TRUE && reset != lit)
+            return invalid("latch reset value");
+        if (!reader.newline() || (lit & 1U) || defined[lit / 2])
+            return invalid("latch");
+        defined[lit / 2] = 1;
+        latch_vars.push_back(lit / 2);
+        this->latches.emplace_back(next, reset);
+    }
+
+    // Outputs and bad states are checked alike: some of them must be 1
+    this->properties.clear();
+    for (unsigned i = 0U; i < nOutputs + nBad; ++i) {
+        unsigned lit;
+        if (!literal(lit) || !reader.newline())
+            return invalid("output");
+        this->properties.push_back(lit);
+    }
+    this->constraints.clear();
+    for (unsigned i = 0U; i < nConstraints; ++i) {
+        unsigned lit;
+        if (!literal(lit) || !reader.newline())
+            return invalid("constraint");
+        this->constraints.push_back(lit);
+    }
+
+    for (unsigned i = 0U; i < this->nAnds; ++i) {
+        unsigned lhs = 2U * (this->nInputs + this->nLatches + i + 1U), rhs0, rhs1;
+        if (binary) {
+            unsigned delta0, delta1;
+            if (!reader.delta(delta0) || !reader.delta(delta1) || delta0 == 0U || delta0 > lhs)
+                return invalid("AND gate");
+            rhs0 = lhs - delta0;
+            if (delta1 > rhs0)
+                return invalid("AND gate");
+            rhs1 = rhs0 - delta1;
+        }
+        else if (!literal(lhs) || !literal(rhs0) || !literal(rhs1) || !reader.newline()) {
+            return invalid("AND gate");
+        }
+        if ((lhs & 1U) || defined[lhs / 2])
+            return invalid("AND gate");
+        defined[lhs / 2] = 1;
+        gates[lhs / 2] = 1;
+        this->ands[lhs / 2] = std::make_pair(rhs0, rhs1);
+    }
+
+    // Gates of an ASCII file need not be sorted, but a cycle through them
+    // defines no circuit. Depth-first search marks each gate 1 while its
+    // inputs are searched and 2 once they are done.
+    std::vector<char> visited(this->maxVar + 1, 0);
+    for (unsigned root = 1U; root <= this->maxVar; ++root) {
+        if (!gates[root] || visited[root])
+            continue;
+        std::vector<std::pair<unsigned, int> > stack(1, std::make_pair(root, 0));
+        visited[root] = 1;
+        while (!stack.empty()) {
+            unsigned var = stack.back().first;
+            int next = stack.back().second++;
+            if (next == 2) {
+                visited[var] = 2;
+                stack.pop_back();
+                continue;
+            }
+            unsigned input = ((next == 0) ? this->ands[var].first : this->ands[var].second) / 2;
+            if (!gates[input] || visited[input] == 2)
+                continue;
+            if (visited[input] == 1)
+                return invalid("AND gates, which are cyclic");
+            visited[input] = 1;
+            stack.emplace_back(input, 0);
+        }
+    }
+
+    // Inputs and free latches of the hashed graph keep the file order
+    this->mapped.assign(this->maxVar + 1, UNMAPPED);
+    this->mapped[0] = AIGER_FALSE;
+    this->nFree = 0U;
+    for (unsigned var : input_vars)
+        this->mapped[var] = 2U * ++this->nFree;
+    for (unsigned i = 0U; i < this->nLatches; ++i) {
+        unsigned reset = this->latches[i].second;
+        if (reset == AIGER_FALSE || reset == AIGER_TRUE)
+            this->mapped[latch_vars[i]] = reset;
+        else
+            this->mapped[latch_vars[i]] = 2U * ++this->nFree;
+    }
+    // A variable used but never defined is a free input in ASCII files
+    for (unsigned var = 1U; var <= this->maxVar; ++var)
+        if (!defined[var])
+            this->mapped[var] = 2U * ++this->nFree;
+    this->nodes.clear();
+    this->hashed.clear();
+
+    return true;
+}
+
+bool AIGER::isAIGER(const char *filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[4];
+    return file.read(magic, 4) && (!std::memcmp(magic, "aag ", 4) || !std::memcmp(magic, "aig ", 4));
+}
+
+unsigned AIGER::mkAnd(unsigned a, unsigned b) {
+
+    if (a > b)
+        std::swap(a, b);
+    if (a == AIGER_FALSE || a == (b ^ 1U))
+        return AIGER_FALSE;
+    if (a == AIGER_TRUE || a == b)
+        return b;
+
+    // Structural hashing keeps one gate per pair of input literals
+    uint64_t key = (static_cast<uint64_t>(a) << 32) | b;
+    auto found = this->hashed.find(key);
+    if (found != this->hashed.end())
+        return found->second;
+    this->nodes.emplace_back(a, b);
+    unsigned lit = 2U * (this->nFree + this->nodes.size());
+    this->hashed.emplace(key, lit);
+    return lit;
+}
+
+unsigned AIGER::map(unsigned lit) {
+
+    if (this->mapped[lit / 2] != UNMAPPED)
+        return this->mapped[lit / 2] ^ (lit & 1U);
+
+    // The gates of an ASCII file need not be sorted, so the inputs of a
+    // gate are mapped on an explicit stack before the gate itself. read
+    // rejected cycles, so this ends.
+    std::vector<unsigned> stack(1, lit / 2);
+    while (!stack.empty()) {
+        unsigned var = stack.back();
+        if (this->mapped[var] != UNMAPPED) {
+            stack.pop_back();
+            continue;
+        }
+        unsigned rhs0 = this->ands[var].first, rhs1 = this->ands[var].second;
+        bool ready = true;
+        for (unsigned input : {rhs0, rhs1}) {
+            if (this->mapped[input / 2] == UNMAPPED) {
+                ready = false;
+                stack.push_back(input / 2);
+            }
+        }
+        if (ready) {
+            this->mapped[var] = this->mkAnd(this->mapped[rhs0 / 2] ^ (rhs0 & 1U),
+                                            this->mapped[rhs1 / 2] ^ (rhs1 & 1U));
+            stack.pop_back();
+        }
+    }
+    return this->mapped[lit / 2] ^ (lit & 1U);
+}
+
+int AIGER::encode(std::vector<int> &literals) {
+
+    std::vector<unsigned> properties, constraints;
+    for (unsigned lit : this->properties)
+        properties.push_back(this->map(lit));
+    for (unsigned lit : this->constraints)
+        constraints.push_back(this->map(lit));
+    // Hashing may map properties onto the same literal, and the solver
+    // expects clauses without repeated literals
+    std::sort(properties.begin(), properties.end());
+    properties.erase(std::unique(properties.begin(), properties.end()), properties.end());
+
+    // Only the inputs, the gates which are reachable from the asserted
+    // literals and the polarities in which they are are encoded
+    unsigned nVars = this->nFree + this->nodes.size();
+    std::vector<char> polarity(nVars + 1, 0);
+    auto need = [&polarity](unsigned lit) {
+        polarity[lit / 2] |= (lit & 1U) ? NEGATIVE : POSITIVE;
+    };
+
+    // Sorted, complementary literals are adjacent
+    bool property_holds = false;
+    for (size_t i = 0; i < properties.size(); ++i)
+        property_holds |= properties[i] == AIGER_TRUE ||
+                          (i > 0 && properties[i] == (properties[i - 1] ^ 1U));
+    if (!property_holds)
+        for (unsigned lit : properties)
+            if (lit != AIGER_FALSE)
+                need(lit);
+    for (unsigned lit : constraints)
+        if (lit != AIGER_FALSE && lit != AIGER_TRUE)
+            need(lit);
+
+    // Gates are created after their inputs, so descending order visits
+    // every gate after all of its fanouts
+    for (unsigned var = nVars; var > this->nFree; --var) {
+        const auto &gate = this->nodes[var - this->nFree - 1U];
+        if (polarity[var] & POSITIVE) {
+            need(gate.first);
+            need(gate.second);
+        }
+        if (polarity[var] & NEGATIVE) {
+            need(gate.first ^ 1U);
+            need(gate.second ^ 1U);
+        }
+    }
+
+    std::vector<int> dimacs(nVars + 1, 0);
+    int maxVarIndex = this->nFree;
+    for (unsigned var = 1U; var <= this->nFree; ++var)
+        dimacs[var] = var;
+    for (unsigned var = this->nFree + 1U; var <= nVars; ++var)
+        if (polarity[var])
+            dimacs[var] = ++maxVarIndex;
+    this->nEncodedAnds = maxVarIndex - this->nFree;
+    auto toDIMACS = [&dimacs](unsigned lit) {
+        return (lit & 1U) ? -dimacs[lit / 2] : dimacs[lit / 2];
+    };
+
+    for (unsigned var = this->nFree + 1U; var <= nVars; ++var) {
+        if (!polarity[var])
+            continue;
+        int g = dimacs[var];
+        int a = toDIMACS(this->nodes[var - this->nFree - 1U].first);
+        int b = toDIMACS(this->nodes[var - this->nFree - 1U].second);
+        // g -> a & b
+        if (polarity[var] & POSITIVE)
+            literals.insert(literals.end(), {-g, a, 0, -g, b, 0});
+        // a & b -> g
+        if (polarity[var] & NEGATIVE)
+            literals.insert(literals.end(), {g, -a, -b, 0});
+    }
+
+    // A false constraint or no possibly true property is the empty clause
+    if (!property_holds) {
+        for (unsigned lit : properties)
+            if (lit != AIGER_FALSE)
+                literals.push_back(toDIMACS(lit));
+        literals.push_back(0);
+    }
+    for (unsigned lit : constraints) {
+        if (lit == AIGER_TRUE)
+            continue;
+        if (lit != AIGER_FALSE)
+            literals.push_back(toDIMACS(lit));
+        literals.push_back(0);
+    }
+
+    return maxVarIndex;
+}
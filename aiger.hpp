@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+
+/**
+ * @brief And-inverter graph read from an AIGER file (ASCII "aag" or
+ *        binary "aig", including the bad and constraint sections of
+ *        AIGER 1.9) and encoded into CNF.
+ *
+ *        The formula is satisfiable iff some output or bad-state literal
+ *        can be 1 while every invariant constraint is 1 and the latches
+ *        hold their reset values; latches without a reset value are free.
+ *        Justice and fairness properties are not supported.
+ *
+ *        AND gates are rebuilt bottom-up with structural hashing and
+ *        constant propagation, only the cone of influence of the asserted
+ *        literals is kept, and gates are encoded with the one-sided
+ *        clauses their polarity needs [Plaisted and Greenbaum, 1986].
+ */
+class AIGER {
+
+public:
+
+    /**
+     * @return false (and print the reason) if the file cannot be read or
+     *         is not valid AIGER
+     */
+    bool read(const char *filename);
+
+    /**
+     * @brief Append the zero-terminated clauses to @c literals. Inputs and
+     *        free latches become variables 1, 2, ... in file order and
+     *        the remaining gates are numbered after them.
+     * @return The largest variable index
+     */
+    int encode(std::vector<int> &literals);
+
+    /// Whether the file starts with an AIGER header
+    static bool isAIGER(const char *filename);
+
+    /// Number of AND gates in the file
+    unsigned getNumAnds() const {
+        return this->nAnds;
+    }
+
+    /// Number of AND gates left after structural hashing
+    unsigned getNumHashedAnds() const {
+        return this->nodes.size();
+    }
+
+    /// Number of AND gates in the cone of influence, i.e. encoded
+    unsigned getNumEncodedAnds() const {
+        return this->nEncodedAnds;
+    }
+
+private:
+
+    /// Literal of the AND of @c a and @c b in the hashed graph
+    unsigned mkAnd(unsigned a, unsigned b);
+
+    /// Literal of @c lit of the file in the hashed graph
+    unsigned map(unsigned lit);
+
+    unsigned maxVar, nInputs, nLatches, nAnds;
+    /// Next state and reset value of each latch
+    std::vector<std::pair<unsigned, unsigned> > latches;
+    /// Literals whose disjunction is asserted
+    std::vector<unsigned> properties;
+    /// Literals each of which is asserted
+    std::vector<unsigned> constraints;
+    /// Inputs of the AND gate defining each variable of the file
+    std::vector<std::pair<unsigned, unsigned> > ands;
+
+    /// Hashed graph: variable 0 is the constant, 1..nFree are inputs and
+    /// free latches, and AND gates follow in topological order
+    unsigned nFree;
+    std::vector<std::pair<unsigned, unsigned> > nodes;
+    std::vector<unsigned> mapped;
+    /// Gates by their ordered pair of input literals
+    std::unordered_map<uint64_t, unsigned> hashed;
+    unsigned nEncodedAnds;
+
+};
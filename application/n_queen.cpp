@@ -1,25 +1,128 @@
 // Reference: https://pyeda.readthedocs.io/en/latest/queens.html
 #include <iostream>
 #include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
 #include <algorithm>
-#include <utility>
-#include <iterator>
 
 #include "../solver.hpp"
 
-std::vector<clause_t> OneHot0(const std::vector<int> &vars) {
-    std::vector<clause_t> clauses;
-    for (size_t i = 0; i < vars.size() - 1; ++i)
-        for (size_t j = i + 1; j < vars.size(); ++j)
-            clauses.push_back({-vars[i], -vars[j]});
-    return clauses;
-}
+/// Pairwise is quadratic in the number of variables, the others linear
+enum amo_encoding_t {
+    PAIRWISE, SEQUENTIAL, COMMANDER, PRODUCT
+};
 
-std::vector<clause_t> OneHot(const std::vector<int> &vars) {
-    std::vector<clause_t> clauses = OneHot0(vars);
-    clauses.push_back(vars);
-    return clauses;
-}
+#define COMMANDER_GROUP_SIZE 3U
+/// Encodings fall back to pairwise below this many variables
+#define PAIRWISE_THRESHOLD 5U
+
+/**
+ * @brief Writes clauses zero-terminated into a flat buffer, the layout
+ *        the Solver is constructed from, and numbers auxiliary variables
+ *        after the N * N board variables
+ */
+class Encoder {
+
+public:
+
+    Encoder(std::vector<int> &literals, int maxVarIndex, amo_encoding_t encoding)
+        : literals(literals), maxVarIndex(maxVarIndex), encoding(encoding) {}
+
+    void clause(std::initializer_list<int> lits) {
+        this->literals.insert(this->literals.end(), lits);
+        this->literals.push_back(0);
+    }
+
+    void AtMostOne(const std::vector<int> &vars) {
+        if (vars.size() < PAIRWISE_THRESHOLD) {
+            this->Pairwise(vars);
+            return;
+        }
+        switch (this->encoding) {
+            case PAIRWISE: this->Pairwise(vars); break;
+            case SEQUENTIAL: this->Sequential(vars); break;
+            case COMMANDER: this->Commander(vars); break;
+            case PRODUCT: this->Product(vars); break;
+        }
+    }
+
+    void ExactlyOne(const std::vector<int> &vars) {
+        this->AtMostOne(vars);
+        this->literals.insert(this->literals.end(), vars.begin(), vars.end());
+        this->literals.push_back(0);
+    }
+
+    int getMaxVarIndex() const {
+        return this->maxVarIndex;
+    }
+
+private:
+
+    void Pairwise(const std::vector<int> &vars) {
+        for (size_t i = 0; i + 1 < vars.size(); ++i)
+            for (size_t j = i + 1; j < vars.size(); ++j)
+                this->clause({-vars[i], -vars[j]});
+    }
+
+    /// Sequential counter [Sinz, 2005]: s_i is true if one of x_1..x_i is
+    void Sequential(const std::vector<int> &vars) {
+        int s = ++this->maxVarIndex;
+        this->clause({-vars[0], s});
+        for (size_t i = 1; i + 1 < vars.size(); ++i) {
+            int next = ++this->maxVarIndex;
+            this->clause({-vars[i], next});
+            this->clause({-s, next});
+            this->clause({-vars[i], -s});
+            s = next;
+        }
+        this->clause({-vars.back(), -s});
+    }
+
+    /// Commander encoding [Klieber and Kwon, 2007]
+    void Commander(const std::vector<int> &vars) {
+        std::vector<int> commanders;
+        for (size_t i = 0; i < vars.size(); i += COMMANDER_GROUP_SIZE) {
+            std::vector<int> group(vars.begin() + i,
+                                   vars.begin() + std::min(vars.size(), i + COMMANDER_GROUP_SIZE));
+            int c = ++this->maxVarIndex;
+            this->Pairwise(group);
+            // The commander is true iff a variable of its group is
+            this->literals.push_back(-c);
+            this->literals.insert(this->literals.end(), group.begin(), group.end());
+            this->literals.push_back(0);
+            for (int var : group)
+                this->clause({-var, c});
+            commanders.push_back(c);
+        }
+        this->AtMostOne(commanders);
+    }
+
+    /// 2-product encoding [Chen, 2010]: x_k is placed on a grid and
+    /// implies its row and column, of which at most one may be true
+    void Product(const std::vector<int> &vars) {
+        size_t p = std::ceil(std::sqrt(vars.size()));
+        size_t q = (vars.size() + p - 1) / p;
+        std::vector<int> u(p), v(q);
+        for (auto &var : u)
+            var = ++this->maxVarIndex;
+        for (auto &var : v)
+            var = ++this->maxVarIndex;
+        for (size_t k = 0; k < vars.size(); ++k) {
+            this->clause({-vars[k], u[k / q]});
+            this->clause({-vars[k], v[k % q]});
+        }
+        this->AtMostOne(u);
+        this->AtMostOne(v);
+    }
+
+    std::vector<int> &literals;
+    int maxVarIndex;
+    amo_encoding_t encoding;
+
+};
 
 static inline void display(const std::vector<int> assignments, int N) {
     for (int row = 0; row < N; ++row) {
@@ -32,121 +135,131 @@ static inline void display(const std::vector<int> assignments, int N) {
 
 int main(int argc, char **argv) {
 
-    int N;
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " N\n";
+    int N = 0;
+    amo_encoding_t encoding = PAIRWISE;
+    unsigned long max_solutions = 0UL;
+    bool counting = false;
+    bool bva = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--amo=pairwise"))
+            encoding = PAIRWISE;
+        else if (!std::strcmp(argv[i], "--amo=sequential"))
+            encoding = SEQUENTIAL;
+        else if (!std::strcmp(argv[i], "--amo=commander"))
+            encoding = COMMANDER;
+        else if (!std::strcmp(argv[i], "--amo=product"))
+            encoding = PRODUCT;
+        else if (!std::strncmp(argv[i], "--solutions=", 12))
+            max_solutions = std::strtoul(argv[i] + 12, nullptr, 10);
+        else if (!std::strcmp(argv[i], "--bva"))
+            bva = true;
+        else if (!std::strcmp(argv[i], "--count"))
+            counting = true;
+        else
+            N = std::atoi(argv[i]);
+    }
+    if (N < 1) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--amo=pairwise|sequential|commander|product] [--bva] [--solutions=K | --count] N\n";
         return 0;
     }
-    N = std::atoi(argv[1]);
 
-    std::vector<clause_t> R, C, DLR, DRL;
+    // Auxiliary variables of the other encodings need not be functions of
+    // the board, so they would be counted along with it
+    if (counting)
+        encoding = PAIRWISE;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<int> literals;
+    Encoder encoder(literals, N * N, encoding);
+    std::vector<int> vars;
 
     // Exactly one queen must be placed on each row
     for (int row = 0; row < N; ++row) {
-        std::vector<int> vars = {};
+        vars.clear();
         for (int col = 1; col <= N; ++col)
             vars.push_back(row * N + col);
-        auto clauses = OneHot(vars);
-        std::copy(clauses.begin(), clauses.end(), std::back_inserter(R));
+        encoder.ExactlyOne(vars);
     }
 
     // Exactly one queen must be placed on each column
     for (int col = 1; col <= N; ++col) {
-        std::vector<int> vars = {};
+        vars.clear();
         for (int row = 0; row < N; ++row)
             vars.push_back(row * N + col);
-        auto clauses = OneHot(vars);
-        std::copy(clauses.begin(), clauses.end(), std::back_inserter(C));
-    }
-
-    // Diagonal Constraints
-    // left-to-right
-    std::vector<std::pair<int, int> > starts;
-    std::vector<std::vector<std::pair<int, int> > > lrdiags;
-    for (int row = N - 1; row > 1; --row)
-        starts.emplace_back(row, 1);
-    for (int col = 1; col < N; ++col)
-        starts.emplace_back(1, col);
-    for (const auto &pos : starts) {
-        lrdiags.push_back({});
-        int row = pos.first;
-        int col = pos.second;
-        while (row <= N && col <= N) {
-            lrdiags.back().emplace_back(row, col);
-            row++;
-            col++;
-        }
+        encoder.ExactlyOne(vars);
     }
-    for (const auto &diag : lrdiags) {
-        std::vector<int> vars = {};
-        for (const auto &pos : diag) {
-            vars.push_back((pos.first - 1) * N + pos.second);
-        }
-        auto clauses = OneHot0(vars);
-        std::copy(clauses.begin(), clauses.end(), std::back_inserter(DLR));
-    }
-
-    // right-to-left
-    starts.clear();
-    std::vector<std::vector<std::pair<int, int> > > rldiags;
-    for (int row = N - 1; row > 1; --row)
-        starts.emplace_back(row, N);
-    for (int col = N; col > 1; --col)
-        starts.emplace_back(1, col);
-    for (const auto &pos : starts) {
-        rldiags.push_back({});
-        int row = pos.first;
-        int col = pos.second;
-        while (row <= N && col >= 1) {
-            rldiags.back().emplace_back(row, col);
-            row++;
-            col--;
-        }
+
+    // Diagonal Constraints, on which row - col (left-to-right) or
+    // row + col (right-to-left) is constant
+    for (int d = -(N - 2); d <= N - 2; ++d) {
+        vars.clear();
+        for (int row = std::max(0, d); row < N && row - d < N; ++row)
+            vars.push_back(row * N + (row - d) + 1);
+        encoder.AtMostOne(vars);
     }
-    for (const auto &diag : rldiags) {
-        std::vector<int> vars = {};
-        for (const auto &pos : diag) {
-            vars.push_back((pos.first - 1) * N + pos.second);
-        }
-        auto clauses = OneHot0(vars);
-        std::copy(clauses.begin(), clauses.end(), std::back_inserter(DRL));
+    for (int d = 1; d <= 2 * N - 3; ++d) {
+        vars.clear();
+        for (int row = std::max(0, d - N + 1); row < N && d - row >= 0; ++row)
+            vars.push_back(row * N + (d - row) + 1);
+        encoder.AtMostOne(vars);
     }
 
-    std::vector<clause_t> clauses;
-    clauses.reserve(R.size() + C.size() + DLR.size() + DRL.size());
-    std::copy(R.begin(), R.end(), std::back_inserter(clauses));
-    std::copy(C.begin(), C.end(), std::back_inserter(clauses));
-    std::copy(DLR.begin(), DLR.end(), std::back_inserter(clauses));
-    std::copy(DRL.begin(), DRL.end(), std::back_inserter(clauses));
+    int maxVarIndex = encoder.getMaxVarIndex();
+    double generation_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t nClauses = std::count(literals.begin(), literals.end(), 0);
 
-    int maxVarIndex = N * N;
     int nSolution = 0;
+    double solving_time = 0.0;
+
+    // All solutions are enumerated, so none of them may be pruned
+    SolverOptions options;
+    options.enumeration = true;
+    options.counting = counting;
+    options.bva = bva;
+
+    // Counted without being enumerated
+    if (counting) {
+        start = std::chrono::steady_clock::now();
+        Solver solver(literals.data(), literals.size(), maxVarIndex, options);
+        BigNum models = solver.count();
+        solving_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "\nNumber of solution to the " << N << " queens puzzle: " << models.toString() << "\n"
+                  << "variables             : " << maxVarIndex << "\n"
+                  << "clauses               : " << nClauses << "\n"
+                  << "generation time       : " << generation_time << " s\n"
+                  << "solving time          : " << solving_time << " s" << std::endl;
+        return 0;
+    }
 
     while (true) {
 
-        Solver solver(clauses, maxVarIndex);
-
-        if (solver.DPLL()) {
-            nSolution++;
-            auto assignments = solver.getAssignments();
-            std::cout << "\nSolution " << nSolution << "\n";
-            display(assignments, N);
-            if (N == 1) {
-                std::cout << "\nNumber of solution to the " << N << " queens puzzle: " 
-                        << nSolution << "\n";
-                break;
-            }
-            for (auto &var : assignments)
-                var *= -1;
-            clauses.push_back(assignments);
-        }
-        else {
-            std::cout << "\nNumber of solution to the " << N << " queens puzzle: " 
-                      << nSolution << std::endl;
-            break;
-        }
+        start = std::chrono::steady_clock::now();
+        Solver solver(literals.data(), literals.size(), maxVarIndex, options);
+        bool sat = solver.DPLL();
+        solving_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
+        if (!sat)
+            break;
+        nSolution++;
+        auto assignments = solver.getAssignments();
+        std::cout << "\nSolution " << nSolution << "\n";
+        display(assignments, N);
+        if (N == 1 || (max_solutions != 0UL && static_cast<unsigned long>(nSolution) >= max_solutions))
+            break;
+        // Auxiliary variables need not be functions of the board, so
+        // only the board is blocked
+        for (int var = 0; var < N * N; ++var)
+            literals.push_back(-assignments[var]);
+        literals.push_back(0);
     }
 
+    std::cout << "\nNumber of solution to the " << N << " queens puzzle: " << nSolution << "\n"
+              << "variables             : " << maxVarIndex << "\n"
+              << "clauses               : " << nClauses << "\n"
+              << "generation time       : " << generation_time << " s\n"
+              << "solving time          : " << solving_time << " s" << std::endl;
+
     return 0;
 }
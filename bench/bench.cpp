@@ -0,0 +1,448 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "../parser.h"
+#include "../solver.hpp"
+#include "../VSIDS.hpp"
+
+#define BENCH_DEPTH 32
+#define FIRSTUIP_REPEATS 16U
+
+/// Every allocation of the process, including those in libyasat
+static unsigned long nAllocations = 0UL;
+
+void *operator new(size_t size) {
+    nAllocations++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief Accumulates wall time, allocations and (if perf_event_open is
+ *        permitted) user-space cache misses over the timed regions of one
+ *        kernel. The counter is toggled outside the clock readings, so the
+ *        syscalls are not part of the reported time.
+ */
+class Probe {
+
+public:
+
+    Probe() : ns(0.0), allocations(0UL), misses(0ULL), ops(0UL) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        this->fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~Probe() {
+        if (this->fd >= 0)
+            close(this->fd);
+    }
+
+    void start() {
+        if (this->fd >= 0) {
+            ioctl(this->fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(this->fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        this->start_allocations = nAllocations;
+        this->start_time = std::chrono::steady_clock::now();
+    }
+
+    void stop(unsigned long ops) {
+        auto end = std::chrono::steady_clock::now();
+        this->allocations += nAllocations - this->start_allocations;
+        if (this->fd >= 0) {
+            ioctl(this->fd, PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t count = 0;
+            if (read(this->fd, &count, sizeof(count)) == sizeof(count))
+                this->misses += count;
+        }
+        this->ns += std::chrono::duration<double, std::nano>(end - this->start_time).count();
+        this->ops += ops;
+    }
+
+    void report(const char *kernel, const std::string &workload) const {
+        double ops = this->ops ? this->ops : 1;
+        std::cout << std::left << std::setw(26) << kernel << std::setw(22) << workload
+                  << std::right << std::setw(10) << this->ops
+                  << std::fixed << std::setprecision(1) << std::setw(12) << this->ns / ops
+                  << std::setprecision(2) << std::setw(12) << this->allocations / ops;
+        if (this->fd >= 0)
+            std::cout << std::setw(12) << this->misses / ops;
+        else
+            std::cout << std::setw(12) << "n/a";
+        std::cout << "\n";
+    }
+
+private:
+
+    int fd;
+    double ns;
+    unsigned long allocations;
+    unsigned long long misses;
+    unsigned long ops;
+    unsigned long start_allocations;
+    std::chrono::steady_clock::time_point start_time;
+
+};
+
+/**
+ * @brief Drives the private kernels of @c Solver; a friend of it
+ */
+class SolverBench {
+
+public:
+
+    SolverBench(const std::vector<clause_t> &clauses, int maxVarIndex, uint64_t seed)
+        : clauses(clauses), maxVarIndex(maxVarIndex), rng(seed) {}
+
+    /**
+     * @brief Descend up to @c BENCH_DEPTH random decisions, propagating
+     *        each to a fixpoint, and unwind; one op is one BCP call
+     */
+    void propagation(const std::string &workload, unsigned nDescents) {
+        Probe probe;
+        SolverOptions options;
+        options.simplify = false;
+        std::vector<clause_t> copy = this->clauses;
+        Solver solver(copy, this->maxVarIndex, options);
+        if (!this->propagateRoot(solver))
+            return;
+        for (unsigned i = 0; i < nDescents; ++i) {
+            int level = 0;
+            bool conflict = false;
+            while (level < BENCH_DEPTH && !conflict) {
+                int var = this->pickUnassigned(solver);
+                if (var == 0)
+                    break;
+                solver.assign(var, nullptr, ++level);
+                unsigned long nCalls = 0UL;
+                probe.start();
+                conflict = !this->propagate(solver, level, nCalls);
+                probe.stop(nCalls);
+            }
+            if (!this->unwind(solver, level))
+                break;
+        }
+        probe.report("BCP", workload);
+    }
+
+    /**
+     * @brief Descend until a conflict and time @c FirstUIP on the frozen
+     *        trail; the propagation and learning in between are not timed
+     */
+    void analysis(const std::string &workload, unsigned nConflicts) {
+        Probe probe;
+        SolverOptions options;
+        options.simplify = false;
+        std::vector<clause_t> copy = this->clauses;
+        Solver solver(copy, this->maxVarIndex, options);
+        if (!this->propagateRoot(solver))
+            return;
+        for (unsigned found = 0, tries = 0; found < nConflicts && tries < 8 * nConflicts; ++tries) {
+            int level = 0;
+            bool conflict = false;
+            while (!conflict) {
+                int var = this->pickUnassigned(solver);
+                if (var == 0)
+                    break;
+                solver.assign(var, nullptr, ++level);
+                unsigned long nCalls = 0UL;
+                conflict = !this->propagate(solver, level, nCalls);
+            }
+            const clause_t *conflicting = conflict ? this->findConflicting(solver, level) : nullptr;
+            if (conflicting != nullptr) {
+                found++;
+                probe.start();
+                for (unsigned r = 0; r < FIRSTUIP_REPEATS; ++r) {
+                    clause_t learned = solver.FirstUIP(conflicting, level);
+                    asm volatile("" : : "g"(learned.data()) : "memory");
+                }
+                probe.stop(FIRSTUIP_REPEATS);
+            }
+            if (!this->unwind(solver, level))
+                break;
+        }
+        probe.report("FirstUIP", workload);
+    }
+
+    /// Resolve random pairs of clauses clashing on one variable
+    void resolution(const std::string &workload, unsigned nOps) {
+        std::vector<std::vector<const clause_t *> > pos(this->maxVarIndex + 1), neg(this->maxVarIndex + 1);
+        for (const auto &clause : this->clauses)
+            for (int var : clause)
+                (var > 0 ? pos[var] : neg[-var]).push_back(&clause);
+        std::vector<int> pivots;
+        for (int var = 1; var <= this->maxVarIndex; ++var)
+            if (!pos[var].empty() && !neg[var].empty())
+                pivots.push_back(var);
+        if (pivots.empty())
+            return;
+
+        Probe probe;
+        for (unsigned i = 0; i < nOps; ++i) {
+            int x = pivots[this->rng() % pivots.size()];
+            const clause_t *F = pos[x][this->rng() % pos[x].size()];
+            const clause_t *G = neg[x][this->rng() % neg[x].size()];
+            probe.start();
+            clause_t resolvent = Solver::resolve(F, G, x);
+            asm volatile("" : : "g"(resolvent.data()) : "memory");
+            probe.stop(1);
+        }
+        probe.report("resolve", workload);
+    }
+
+    /// Bump random learned-like clauses, then pick under random partial assignments
+    void heuristic(const std::string &workload, unsigned nOps) {
+        std::vector<int> assignments(this->maxVarIndex + 1, branching_heuristic::UNASSIGNED);
+        unsigned nConflicts = 0U;
+        VSIDS vsids(this->clauses, this->maxVarIndex, &assignments, &nConflicts);
+
+        Probe update;
+        clause_t clause;
+        for (unsigned i = 0; i < nOps; ++i) {
+            clause.clear();
+            int size = 3 + this->rng() % 8;
+            for (int k = 0; k < size; ++k) {
+                int var = 1 + this->rng() % this->maxVarIndex;
+                clause.push_back(this->rng() & 1 ? var : -var);
+            }
+            nConflicts++;
+            update.start();
+            vsids.update(clause);
+            update.stop(1);
+        }
+        update.report("VSIDS::update", workload);
+
+        Probe pick;
+        for (unsigned i = 0; i < nOps; ++i) {
+            // Fresh random trail of about half the variables every 64 picks
+            if (i % 64 == 0)
+                for (int var = 1; var <= this->maxVarIndex; ++var)
+                    assignments[var] = (this->rng() & 1) ? branching_heuristic::UNASSIGNED
+                                                         : branching_heuristic::TRUE;
+            pick.start();
+            int var = vsids.getNextDicisionVariable();
+            pick.stop(1);
+            if (var != 0)
+                assignments[std::abs(var)] = branching_heuristic::TRUE;
+        }
+        pick.report("VSIDS::getNextDicision", workload);
+    }
+
+private:
+
+    bool propagate(Solver &solver, int level, unsigned long &nCalls) {
+        while (!solver.imply_queue.empty()) {
+            int var = solver.imply_queue.front();
+            solver.imply_queue.pop();
+            nCalls++;
+            if (solver.BCP(var, level) == Solver::ECONFLICT)
+                return false;
+        }
+        return true;
+    }
+
+    bool propagateRoot(Solver &solver) {
+        unsigned long nCalls = 0UL;
+        return !solver.has_empty_clause && this->propagate(solver, 0, nCalls);
+    }
+
+    /**
+     * @brief Undo every level above the root. A conflict may have learned
+     *        root units, so the root is propagated again from scratch.
+     * @return false if the root level became conflicting
+     */
+    bool unwind(Solver &solver, int level) {
+        for (int l = level; l > 0; --l)
+            solver.unassign(l);
+        solver.imply_queue = {};
+        solver.jump_to = std::nullopt;
+        for (const auto &assigned : solver.assigned_levels[0])
+            solver.imply_queue.push(assigned.first);
+        return this->propagateRoot(solver);
+    }
+
+    int pickUnassigned(Solver &solver) {
+        for (int tries = 0; tries < 4 * this->maxVarIndex; ++tries) {
+            int var = 1 + this->rng() % this->maxVarIndex;
+            if (solver.assignments[var] == Solver::UNASSIGNED)
+                return (this->rng() & 1) ? var : -var;
+        }
+        for (int var = 1; var <= this->maxVarIndex; ++var)
+            if (solver.assignments[var] == Solver::UNASSIGNED)
+                return var;
+        return 0;
+    }
+
+    /// A falsified clause with at least two literals on @c level
+    const clause_t *findConflicting(const Solver &solver, int level) const {
+        for (const auto &clause : solver.clauses) {
+            int nAtLevel = 0;
+            bool falsified = true;
+            for (int var : clause) {
+                int assignment = solver.assignments[std::abs(var)];
+                if (assignment == Solver::UNASSIGNED ||
+                    (assignment == Solver::TRUE) == (var > 0)) {
+                    falsified = false;
+                    break;
+                }
+                nAtLevel += solver.assigned_levels_reverse[std::abs(var)] == level;
+            }
+            if (falsified && nAtLevel >= 2)
+                return &clause;
+        }
+        return nullptr;
+    }
+
+    const std::vector<clause_t> &clauses;
+    int maxVarIndex;
+    std::mt19937_64 rng;
+
+};
+
+/// Uniform random k-SAT, written in DIMACS as well
+static std::vector<clause_t> randomFormula(int nVars, double ratio, int k, uint64_t seed,
+                                           std::string &dimacs) {
+    std::mt19937_64 rng(seed);
+    std::vector<clause_t> clauses(static_cast<size_t>(nVars * ratio));
+    std::ostringstream out;
+    out << "p cnf " << nVars << " " << clauses.size() << "\n";
+    for (auto &clause : clauses) {
+        while (static_cast<int>(clause.size()) < k) {
+            int var = 1 + rng() % nVars;
+            if (std::find(clause.begin(), clause.end(), var) == clause.end() &&
+                std::find(clause.begin(), clause.end(), -var) == clause.end())
+                clause.push_back((rng() & 1) ? var : -var);
+        }
+        for (int var : clause)
+            out << var << " ";
+        out << "0\n";
+    }
+    dimacs = out.str();
+    return clauses;
+}
+
+static void parsing(const std::string &workload, const char *filename, const std::string &dimacs,
+                    unsigned nRepeats) {
+    Probe file;
+    for (unsigned i = 0; i < nRepeats; ++i) {
+        std::vector<clause_t> clauses;
+        int maxVarIndex;
+        file.start();
+        parse_DIMACS_CNF(clauses, maxVarIndex, filename);
+        file.stop(dimacs.size());
+    }
+    file.report("parse_DIMACS_CNF (byte)", workload);
+
+    Probe buffer;
+    std::vector<int> literals;
+    for (unsigned i = 0; i < nRepeats; ++i) {
+        int maxVarIndex;
+        literals.clear();
+        buffer.start();
+        parse_DIMACS_buffer(literals, maxVarIndex, dimacs.data(), dimacs.size());
+        buffer.stop(dimacs.size());
+    }
+    buffer.report("parse_DIMACS_buffer (byte)", workload);
+}
+
+static void run(const std::string &workload, const std::vector<clause_t> &clauses, int maxVarIndex,
+                const char *filename, const std::string &dimacs, uint64_t seed) {
+    SolverBench bench(clauses, maxVarIndex, seed);
+    bench.propagation(workload, 200U);
+    bench.analysis(workload, 200U);
+    bench.resolution(workload, 100000U);
+    bench.heuristic(workload, 20000U);
+    parsing(workload, filename, dimacs, 5U);
+}
+
+int main(int argc, char **argv) {
+
+    int nVars = 5000;
+    double ratio = 4.0;
+    uint64_t seed = 1;
+    std::vector<const char *> inputs;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strncmp(argv[i], "--vars=", 7))
+            nVars = std::atoi(argv[i] + 7);
+        else if (!std::strncmp(argv[i], "--ratio=", 8))
+            ratio = std::atof(argv[i] + 8);
+        else if (!std::strncmp(argv[i], "--seed=", 7))
+            seed = std::strtoull(argv[i] + 7, nullptr, 10);
+        else if (!std::strcmp(argv[i], "--help")) {
+            std::cerr << "Usage: " << argv[0] << " [--vars=N] [--ratio=R] [--seed=S] [input.cnf...]\n";
+            return 0;
+        }
+        else
+            inputs.push_back(argv[i]);
+    }
+
+    std::cout << std::left << std::setw(26) << "kernel" << std::setw(22) << "workload"
+              << std::right << std::setw(10) << "ops" << std::setw(12) << "ns/op"
+              << std::setw(12) << "allocs/op" << std::setw(12) << "misses/op" << "\n";
+
+    // Synthetic: random 3-SAT, written to a temporary file for the file parser
+    std::string dimacs;
+    std::vector<clause_t> clauses = randomFormula(nVars, ratio, 3, seed, dimacs);
+    char filename[] = "/tmp/yasat_benchXXXXXX";
+    int fd = mkstemp(filename);
+    if (fd < 0 || write(fd, dimacs.data(), dimacs.size()) != static_cast<ssize_t>(dimacs.size())) {
+        std::cerr << "Cannot write " << filename << "\n";
+        return 1;
+    }
+    close(fd);
+    std::ostringstream name;
+    name << "random3-" << nVars << "-" << ratio;
+    run(name.str(), clauses, nVars, filename, dimacs, seed);
+    unlink(filename);
+
+    // Recorded: the given instances
+    for (const char *input : inputs) {
+        std::ifstream file(input);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << input << "\n";
+            continue;
+        }
+        std::stringstream text;
+        text << file.rdbuf();
+        std::vector<clause_t> recorded;
+        int maxVarIndex;
+        parse_DIMACS_CNF(recorded, maxVarIndex, input);
+        std::string workload(input);
+        workload = workload.substr(workload.find_last_of('/') + 1);
+        run(workload, recorded, maxVarIndex, input, text.str(), seed);
+    }
+    return 0;
+}
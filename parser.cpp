@@ -83,29 +83,41 @@ void readClause(StreamBuffer &in, vector<vector<int> > &clauses) {
 }
 
 
-void parse_DIMACS_main(StreamBuffer &in, vector<vector<int> > &clauses) {
+void parse_DIMACS_main(StreamBuffer &in, vector<vector<int> > &clauses,
+		       int &nDeclaredVars) {
   while (true) {
     skipWhitespace(in);
     if (*in == EOF) break;
-    else if (*in == 'c' || *in == 'p') skipLine(in);
+    else if (*in == 'p') {
+      // "p cnf <variables> <clauses>"
+      ++in;
+      skipWhitespace(in);
+      while (*in != EOF && !((*in >= 9 && *in <= 13) || *in == 32))
+	++in;
+      nDeclaredVars = parseInt(in);
+      skipLine(in);
+    }
+    else if (*in == 'c') skipLine(in);
     else readClause(in, clauses);
   }
 }
 
 
 //void parse_DIMACS(gzFile input_stream, vector<vector<int> > &clauses)
-void parse_DIMACS(FILE *input_stream, vector<vector<int> > &clauses)
+void parse_DIMACS(FILE *input_stream, vector<vector<int> > &clauses,
+		  int &nDeclaredVars)
 {
   StreamBuffer in(input_stream);
-  parse_DIMACS_main(in, clauses);
+  parse_DIMACS_main(in, clauses, nDeclaredVars);
 }
 
 
 void parse_DIMACS_CNF(vector<vector<int> > &clauses,
 		      int &maxVarIndex,
-		      const char *DIMACS_cnf_file) {
+		      const char *DIMACS_cnf_file,
+		      int *nDeclaredVars) {
   unsigned int i, j;
-  int candidate;
+  int candidate, declared = 0;
   //gzFile in = gzopen(DIMACS_cnf_file, "rb");
   FILE *in = fopen(DIMACS_cnf_file, "r");
   if (in == NULL) {
@@ -113,7 +125,9 @@ void parse_DIMACS_CNF(vector<vector<int> > &clauses,
 	    DIMACS_cnf_file);
     exit(1);
   }
-  parse_DIMACS(in, clauses);
+  parse_DIMACS(in, clauses, declared);
+  if (nDeclaredVars != NULL)
+    *nDeclaredVars = declared;
   //gzclose(in);
   fclose(in);
 
@@ -125,3 +139,42 @@ void parse_DIMACS_CNF(vector<vector<int> > &clauses,
     }
 }
 
+
+
+bool parse_DIMACS_buffer(vector<int> &literals,
+			 int &maxVarIndex,
+			 const char *buffer,
+			 size_t length,
+			 int maxVarBound) {
+  const char *in = buffer, *end = buffer + length;
+  bool open_clause = false;
+  maxVarIndex = 0;
+  while (true) {
+    while (in < end && ((*in >= 9 && *in <= 13) || *in == 32))
+      ++in;
+    if (in == end) break;
+    if (*in == 'c' || *in == 'p' || *in == '%') {
+      while (in < end && *in != '\n') ++in;
+      continue;
+    }
+    bool neg = false;
+    if      (*in == '-') neg = true, ++in;
+    else if (*in == '+') ++in;
+    if (in == end || *in < '0' || *in > '9')
+      return false;
+    int val = 0;
+    while (in < end && *in >= '0' && *in <= '9') {
+      if (val > (maxVarBound - (*in - '0')) / 10)
+        return false;
+      val = val*10 + (*in - '0');
+      ++in;
+    }
+    literals.push_back(neg ? -val : val);
+    if (val > maxVarIndex) maxVarIndex = val;
+    open_clause = (val != 0);
+  }
+  // The last clause may miss its terminating zero
+  if (open_clause)
+    literals.push_back(0);
+  return true;
+}
@@ -9,6 +9,8 @@
 #ifndef __PARSER_H__
 #  define __PARSER_H__
 #include <vector>
+#include <cstddef>
+#include <climits>
 using std::vector;
 
 
@@ -35,9 +37,29 @@ using std::vector;
 // expression `clauses[i]'.  The jth literal of `clauses[i]' can be
 // referred to using `clauses[i][j]'.  The expression `clauses.size()'
 // tells you the number of clauses in the benchmark.
+//
+// If `nDeclaredVars' is given, it receives the variable count of the
+// "p cnf" header (0 without one), which may exceed `maxVarIndex' when
+// some declared variables appear in no clause.
 void parse_DIMACS_CNF(vector<vector<int> > &clauses,
 		      int &maxVarIndex,
-		      const char *DIMACS_cnf_file);
+		      const char *DIMACS_cnf_file,
+		      int *nDeclaredVars = NULL);
+
+
+// parse_DIMACS_buffer
+//
+// Parse DIMACS CNF text held in memory, e.g. received over a socket.
+// The clauses are appended to `literals' flat and zero-terminated, the
+// layout the Solver can be constructed from, so a caller can reuse the
+// same vector across formulas.  Unlike parse_DIMACS_CNF this does not
+// exit on malformed input but returns false, which includes variables
+// above `maxVarBound' since the Solver allocates per variable index.
+bool parse_DIMACS_buffer(vector<int> &literals,
+			 int &maxVarIndex,
+			 const char *buffer,
+			 size_t length,
+			 int maxVarBound = INT_MAX);
 
 
 
@@ -2,33 +2,221 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <cstring>
 #include <iterator>
+#include <algorithm>
+#include <utility>
 
 #undef NDEBUG
 #include <cassert>
 
 #include "parser.h"
 #include "solver.hpp"
+#include "ProbSAT.hpp"
+#include "ycnf.hpp"
+#include "aiger.hpp"
 
 typedef std::vector<int> clause_t;
 
 int main(int argc, char **argv) {
 
-    assert("Usage: ./yasat [input.cnf]" && argc > 1);
+    assert("Usage: ./yasat [--sls | --sls-interleave] [--sls-flips=N] [--chrono] [--chrono-threshold=T] [--gauss] [--branching=vsids|lrb|jw|bandit] [--lookahead] [--cube=D] [--symmetry] [--bva] [--count] [--count-cache=MB] [--no-truth-table] [--load-snapshot=F] [--save-snapshot=F] [--trace=F] [input.cnf | input.ycnf | input.aag | input.aig]\n"
+           "       ./yasat --compile input.cnf output.ycnf" && argc > 1);
+
+    // Compile a DIMACS file into an image which later runs map instead of parsing
+    if (!std::strcmp(argv[1], "--compile")) {
+        assert("Usage: ./yasat --compile input.cnf output.ycnf" && argc == 4);
+        std::vector<clause_t> clauses;
+        int maxVarIndex, nDeclaredVars;
+        parse_DIMACS_CNF(clauses, maxVarIndex, argv[2], &nDeclaredVars);
+        // Declared variables in no clause still count as models
+        maxVarIndex = std::max(maxVarIndex, nDeclaredVars);
+        if (!compileCNF(clauses, maxVarIndex, argv[3])) {
+            std::cerr << "Cannot write the image " << argv[3] << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    SolverOptions options;
+    bool sls_standalone = false;
+    const char *input_filename = nullptr;
+    const char *load_snapshot = nullptr;
+    const char *save_snapshot = nullptr;
+    const char *trace_filename = nullptr;
+    int cube_depth = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--sls"))
+            sls_standalone = true;
+        else if (!std::strcmp(argv[i], "--sls-interleave"))
+            options.sls_interleave = true;
+        else if (!std::strncmp(argv[i], "--sls-flips=", 12))
+            options.sls_flips = std::strtoul(argv[i] + 12, nullptr, 10);
+        else if (!std::strncmp(argv[i], "--load-snapshot=", 16))
+            load_snapshot = argv[i] + 16;
+        else if (!std::strncmp(argv[i], "--save-snapshot=", 16))
+            save_snapshot = argv[i] + 16;
+        else if (!std::strncmp(argv[i], "--trace=", 8))
+            trace_filename = argv[i] + 8;
+        else if (!std::strcmp(argv[i], "--bva"))
+            options.bva = true;
+        else if (!std::strcmp(argv[i], "--count"))
+            options.counting = true;
+        else if (!std::strncmp(argv[i], "--count-cache=", 14))
+            options.count_cache_mb = std::strtoul(argv[i] + 14, nullptr, 10);
+        else if (!std::strcmp(argv[i], "--no-truth-table"))
+            options.truth_table = false;
+        else if (!std::strcmp(argv[i], "--symmetry"))
+            options.symmetry_breaking = true;
+        else if (!std::strcmp(argv[i], "--gauss"))
+            options.gauss = true;
+        else if (!std::strcmp(argv[i], "--branching=vsids"))
+            options.branching = BRANCH_VSIDS;
+        else if (!std::strcmp(argv[i], "--branching=lrb"))
+            options.branching = BRANCH_LRB;
+        else if (!std::strcmp(argv[i], "--branching=jw"))
+            options.branching = BRANCH_JW;
+        else if (!std::strcmp(argv[i], "--branching=bandit"))
+            options.branching = BRANCH_BANDIT;
+        else if (!std::strcmp(argv[i], "--lookahead"))
+            options.lookahead = true;
+        else if (!std::strncmp(argv[i], "--cube=", 7))
+            cube_depth = std::atoi(argv[i] + 7);
+        else if (!std::strcmp(argv[i], "--chrono"))
+            options.chrono_backtrack = true;
+        else if (!std::strncmp(argv[i], "--chrono-threshold=", 19))
+            options.chrono_threshold = std::atoi(argv[i] + 19);
+        else
+            input_filename = argv[i];
+    }
+    assert("No input file" && input_filename != nullptr);
 
     std::vector<clause_t> clauses;
     int maxVarIndex;
+    CNFImage image;
+    bool compiled = CNFImage::isImage(input_filename);
+    bool circuit = !compiled && AIGER::isAIGER(input_filename);
+    // Gate variables of the polarity-aware encoding are not determined by
+    // the inputs, so their models do not count those of the circuit
+    if (circuit && options.counting) {
+        std::cerr << "Cannot count the models of a circuit\n";
+        return 1;
+    }
+    // A circuit is encoded straight into the flat layout
+    std::vector<int> literals;
 
-    parse_DIMACS_CNF(clauses, maxVarIndex, argv[1]);
-
-    Solver solver(clauses, maxVarIndex);
+    if (compiled) {
+        if (!image.open(input_filename)) {
+            std::cerr << "Invalid image " << input_filename << "\n";
+            return 1;
+        }
+        maxVarIndex = image.getHeader().maxVarIndex;
+    }
+    else if (circuit) {
+        AIGER aiger;
+        if (!aiger.read(input_filename))
+            return 1;
+        maxVarIndex = aiger.encode(literals);
+#ifdef DEBUG
+        std::clog << "AND gates             : " << aiger.getNumAnds() << "\n"
+                  << "after hashing         : " << aiger.getNumHashedAnds() << "\n"
+                  << "encoded               : " << aiger.getNumEncodedAnds() << "\n";
+#endif
+    }
+    else {
+        int nDeclaredVars;
+        parse_DIMACS_CNF(clauses, maxVarIndex, input_filename, &nDeclaredVars);
+        // Models over the declared variables, as the model counting 
+        // competition defines them
+        if (options.counting)
+            maxVarIndex = std::max(maxVarIndex, nDeclaredVars);
+    }
 
-    std::string output_filename(argv[1]);
-    output_filename = output_filename.substr(0UL, output_filename.length() - 4UL) + ".sat";
+    std::string output_filename(input_filename);
+    output_filename = output_filename.substr(0UL, output_filename.length() - (compiled ? 5UL : 4UL)) + 
+                      (cube_depth > 0 ? ".cubes" : ".sat");
     std::ofstream output_file(output_filename);
     assert("Cannot open the output file" && output_file.is_open());
 
-    if (solver.DPLL()) {
+    // Local search and cube splitting work on clause vectors
+    bool need_clauses = sls_standalone || cube_depth > 0;
+    if (need_clauses && compiled) {
+        const uint64_t *offsets = image.getOffsets();
+        const int32_t *literals = image.getLiterals();
+        for (uint64_t i = 0; i < image.getHeader().nClauses; ++i)
+            clauses.emplace_back(literals + offsets[i], literals + offsets[i + 1]);
+    }
+    if (need_clauses && circuit) {
+        clauses.emplace_back();
+        for (int lit : literals) {
+            if (lit != 0)
+                clauses.back().push_back(lit);
+            else
+                clauses.emplace_back();
+        }
+        clauses.pop_back();
+    }
+
+    // Split into cubes, one "a <literals> 0" line each, for other solvers
+    // to conquer; no line at all means UNSAT
+    if (cube_depth > 0) {
+        Lookahead lookahead(clauses, maxVarIndex, nullptr);
+        auto cubes = lookahead.cube(cube_depth);
+        for (const auto &cube : cubes) {
+            output_file << "a ";
+            std::copy(cube.begin(), cube.end(), std::ostream_iterator<int>(output_file, " "));
+            output_file << "0\n";
+        }
+#ifdef DEBUG
+        std::clog << "\ncubes                 : " << cubes.size() << "\n";
+#endif
+        output_file.close();
+        return 0;
+    }
+
+    if (sls_standalone) {
+        // Incomplete: give up with UNKNOWN once the flip budget is spent
+        ProbSAT sls(clauses, maxVarIndex);
+        std::vector<bool> initial(maxVarIndex + 1, false), fixed(maxVarIndex + 1, false);
+        if (sls.solve(initial, fixed, options.sls_flips)) {
+            const auto &model = sls.getBestAssignment();
+            output_file << "s SATISFIABLE\nv ";
+            for (int var = 1; var <= maxVarIndex; ++var)
+                output_file << (model[var] ? var : -var) << " ";
+            output_file << "0\n";
+        }
+        else {
+            output_file << "s UNKNOWN\n";
+        }
+#ifdef DEBUG
+        std::clog << "\nflips                 : " << sls.getFlips() << "\n";
+#endif
+        output_file.close();
+        return 0;
+    }
+
+    // The solver picks up the ring of this thread on construction
+    if (trace_filename != nullptr && !Tracer::start(trace_filename)) {
+        std::cerr << "Cannot write the trace " << trace_filename << "\n";
+        return 1;
+    }
+    Solver solver = compiled ? Solver(image, options) :
+                    circuit ? Solver(literals.data(), literals.size(), maxVarIndex, options) :
+                              Solver(std::move(clauses), maxVarIndex, options);
+    if (load_snapshot != nullptr)
+        solver.loadSnapshot(load_snapshot);
+
+    if (options.counting) {
+        // Models over all variables, in "s mc" lines of the model counting 
+        // competition
+        BigNum models = solver.count();
+        if (solver.isAborted())
+            output_file << "s UNKNOWN\n";
+        else
+            output_file << "s mc " << models.toString() << "\n";
+    }
+    else if (solver.DPLL()) {
         output_file << "s SATISFIABLE\nv ";
         auto assignments = solver.getAssignments();
         std::copy(assignments.begin(), assignments.end(), 
@@ -39,6 +227,10 @@ int main(int argc, char **argv) {
         output_file << "s UNSATISFIABLE\n";
     }
 
+    if (save_snapshot != nullptr && !solver.saveSnapshot(save_snapshot))
+        std::cerr << "Cannot write the snapshot " << save_snapshot << "\n";
+    Tracer::stop();
+
 #ifdef DEBUG
     solver.printStatistics();
 #endif
@@ -0,0 +1,167 @@
+#include "solver.hpp"
+#include "snapshot.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool Solver::saveSnapshot(const char *filename) const {
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::vector<int32_t> units;
+    for (const auto &assigned : this->assigned_levels[0])
+        units.push_back(assigned.first);
+
+    std::vector<int32_t> scores(2 * this->maxVarIndex, 0);
+    const VSIDS *vsids = dynamic_cast<const VSIDS *>(this->selector);
+    if (vsids != nullptr)
+        for (int var = 1; var <= this->maxVarIndex; ++var) {
+            scores[2 * (var - 1)] = vsids->getScores()[var].first;
+            scores[2 * (var - 1) + 1] = vsids->getScores()[var].second;
+        }
+
+    std::vector<uint32_t> sizes;
+    std::vector<int32_t> literals;
+    for (size_t i = this->nInputClauses; i < this->clauses.size(); ++i) {
+        sizes.push_back(this->clauses[i].size());
+        literals.insert(literals.end(), this->clauses[i].begin(), this->clauses[i].end());
+    }
+
+    // The current (possibly final) assignment takes precedence over phases
+    std::vector<uint8_t> phases(this->maxVarIndex);
+    for (int var = 1; var <= this->maxVarIndex; ++var)
+        phases[var - 1] = (this->assignments[var] != UNASSIGNED) ? this->assignments[var] : this->phases[var];
+
+    snapshot_header header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = SNAPSHOT_VERSION;
+    header.formula_hash = this->formula_hash;
+    header.maxVarIndex = this->maxVarIndex;
+    header.nUnits = units.size();
+    header.nLearned = sizes.size();
+    header.nLearnedLiterals = literals.size();
+    header.flags = (vsids != nullptr) ? SNAPSHOT_HAS_SCORES : 0U;
+    header.reserved = 0U;
+
+    auto write = [&file](const void *data, size_t size) {
+        file.write(static_cast<const char *>(data), size);
+    };
+    write(&header, sizeof(header));
+    write(units.data(), units.size() * sizeof(int32_t));
+    write(scores.data(), scores.size() * sizeof(int32_t));
+    write(this->lbds.data(), this->lbds.size() * sizeof(uint32_t));
+    write(sizes.data(), sizes.size() * sizeof(uint32_t));
+    write(literals.data(), literals.size() * sizeof(int32_t));
+    write(phases.data(), phases.size());
+
+    return file.good();
+}
+
+bool Solver::loadSnapshot(const char *filename) {
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(snapshot_header)) {
+        close(fd);
+        return false;
+    }
+    size_t length = st.st_size;
+    void *image = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED)
+        return false;
+
+    const char *base = static_cast<const char *>(image);
+    const snapshot_header *header = static_cast<const snapshot_header *>(image);
+    size_t nVars = std::max(header->maxVarIndex, 0);
+    size_t expected = sizeof(snapshot_header)
+                    + sizeof(int32_t) * (header->nUnits + 2 * nVars + header->nLearnedLiterals)
+                    + sizeof(uint32_t) * 2 * header->nLearned + nVars;
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, 4) || header->version != SNAPSHOT_VERSION ||
+        expected != length) {
+        munmap(image, length);
+        return false;
+    }
+
+    const int32_t *units = reinterpret_cast<const int32_t *>(base + sizeof(snapshot_header));
+    const int32_t *scores = units + header->nUnits;
+    const uint32_t *lbds = reinterpret_cast<const uint32_t *>(scores + 2 * nVars);
+    const uint32_t *sizes = lbds + header->nLearned;
+    const int32_t *literals = reinterpret_cast<const int32_t *>(sizes + header->nLearned);
+    const uint8_t *phases = reinterpret_cast<const uint8_t *>(literals + header->nLearnedLiterals);
+
+    // A corrupted file may still match in length, so the clause sizes and
+    // every literal are checked before any of them is used as an index
+    uint64_t nLiterals = 0ULL;
+    for (uint32_t i = 0; i < header->nLearned; ++i)
+        nLiterals += sizes[i];
+    auto inRange = [header](int32_t var) {
+        return var != 0 && var >= -header->maxVarIndex && var <= header->maxVarIndex;
+    };
+    if (nLiterals != header->nLearnedLiterals ||
+        !std::all_of(units, units + header->nUnits, inRange) ||
+        !std::all_of(literals, literals + header->nLearnedLiterals, inRange)) {
+        munmap(image, length);
+        return false;
+    }
+
+    // Heuristic state is useful on a modified formula as well
+    int nCommonVars = std::min(header->maxVarIndex, this->maxVarIndex);
+    // Zero scores of another heuristic would wipe the initial ones
+    VSIDS *vsids = dynamic_cast<VSIDS *>(this->selector);
+    if (vsids != nullptr && (header->flags & SNAPSHOT_HAS_SCORES)) {
+        auto vsids_scores = vsids->getScores();
+        for (int var = 1; var <= nCommonVars; ++var)
+            vsids_scores[var] = {scores[2 * (var - 1)], scores[2 * (var - 1) + 1]};
+        vsids->setScores(vsids_scores);
+    }
+    for (int var = 1; var <= nCommonVars; ++var)
+        if (phases[var - 1] == TRUE || phases[var - 1] == FALSE)
+            this->phases[var] = phases[var - 1];
+    this->use_saved_phases = true;
+
+    // Learned clauses and units are only implied by the same formula
+    bool same_formula = header->formula_hash == this->formula_hash &&
+                        header->maxVarIndex == this->maxVarIndex;
+    if (same_formula) {
+        for (uint32_t i = 0; i < header->nUnits; ++i) {
+            int var = units[i];
+            if (this->assignments[std::abs(var)] != UNASSIGNED ||
+                this->clauses.size() >= this->clauses_capacity)
+                continue;
+            this->clauses.push_back({var});
+            this->lbds.push_back(1U);
+            this->constructWatchingLists(this->clauses.back());
+        }
+        const int32_t *lits = literals;
+        for (uint32_t i = 0; i < header->nLearned; lits += sizes[i++]) {
+            if (sizes[i] == 0U || this->clauses.size() >= this->clauses_capacity)
+                continue;
+            if (sizes[i] == 1U && this->assignments[std::abs(lits[0])] != UNASSIGNED)
+                continue;
+            this->clauses.emplace_back(lits, lits + sizes[i]);
+            this->lbds.push_back(lbds[i]);
+            this->constructWatchingLists(this->clauses.back());
+        }
+    }
+
+#ifdef DEBUG
+    std::clog << "Loaded snapshot with " << header->nLearned << " learned clauses and "
+              << header->nUnits << " units" << (same_formula ? "" : " (formula changed, skipped)")
+              << "\n";
+#endif
+
+    munmap(image, length);
+    return same_formula;
+}
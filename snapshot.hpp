@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+typedef std::vector<int> clause_t;
+
+#define SNAPSHOT_MAGIC "YSNP"
+#define SNAPSHOT_VERSION 2U
+/// Flag of a snapshot taken with VSIDS, whose scores it holds
+#define SNAPSHOT_HAS_SCORES 1U
+
+/**
+ * @brief Layout of a solver snapshot file. The header is followed by
+ *        int32 root units, int32 pairs of VSIDS scores (zero unless 
+ *        SNAPSHOT_HAS_SCORES is set), uint32 LBDs and
+ *        sizes of learned clauses, their int32 literals and finally one
+ *        byte per variable holding its saved phase.
+ */
+struct snapshot_header {
+    char magic[4];
+    uint32_t version;
+    /// Hash of the input formula the snapshot was taken on
+    uint64_t formula_hash;
+    int32_t maxVarIndex;
+    uint32_t nUnits;
+    uint32_t nLearned;
+    uint32_t nLearnedLiterals;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+/**
+ * @brief FNV-1a hash of the clauses in their input order
+ */
+inline uint64_t hashFormula(const std::vector<clause_t> &clauses, int maxVarIndex) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto feed = [&hash](uint32_t word) {
+        for (int i = 0; i < 4; ++i) {
+            hash ^= (word >> (8 * i)) & 0xFFU;
+            hash *= 1099511628211ULL;
+        }
+    };
+    feed(maxVarIndex);
+    for (const auto &clause : clauses) {
+        for (int var : clause)
+            feed(var);
+        feed(0U);
+    }
+    return hash;
+}
@@ -1,4 +1,5 @@
 #include "solver.hpp"
+#include "snapshot.hpp"
 
 #include <iostream>
 #include <algorithm>
@@ -11,25 +12,159 @@
 #define MIN_LEN_OF_LEARNED_CLAUSE 10
 #define CLAUSES_CAPACITY_MULTIPLIER 100
 
-Solver::Solver(std::vector<clause_t> &clauses, int maxVarIndex) {
-
+Solver::Solver(std::vector<clause_t> &clauses, int maxVarIndex,
+               const SolverOptions &options/*=SolverOptions()*/) {
     this->clauses = clauses;
-    this->maxVarIndex = maxVarIndex;
+    this->initialize(maxVarIndex, options);
+}
+
+Solver::Solver(std::vector<clause_t> &&clauses, int maxVarIndex,
+               const SolverOptions &options/*=SolverOptions()*/) {
+    this->clauses = std::move(clauses);
+    this->initialize(maxVarIndex, options);
+}
+
+Solver::Solver(const int *literals, size_t nLiterals, int maxVarIndex/*=-1*/,
+               const SolverOptions &options/*=SolverOptions()*/) {
+
+    // Clauses are built in place straight from the buffer
+    size_t nClauses = std::count(literals, literals + nLiterals, 0);
+    this->clauses.reserve(CLAUSES_CAPACITY_MULTIPLIER * (nClauses + 1));
+    int maxVar = 0;
+    const int *begin = literals;
+    for (const int *p = literals; p != literals + nLiterals; ++p) {
+        if (*p == 0) {
+            this->clauses.emplace_back(begin, p);
+            begin = p + 1;
+        }
+        else
+            maxVar = std::max(maxVar, std::abs(*p));
+    }
+    // The last clause may lack its terminating zero
+    if (begin != literals + nLiterals)
+        this->clauses.emplace_back(begin, literals + nLiterals);
+
+    this->initialize(maxVarIndex < 0 ? maxVar : maxVarIndex, options);
+}
+
+Solver::Solver(const CNFImage &image, const SolverOptions &options/*=SolverOptions()*/) {
+
+    const ycnf_header &header = image.getHeader();
+    const uint64_t *offsets = image.getOffsets();
+    const int32_t *literals = image.getLiterals();
+    this->clauses.reserve(CLAUSES_CAPACITY_MULTIPLIER * (header.nClauses + 1));
+    for (uint64_t i = 0; i < header.nClauses; ++i)
+        this->clauses.emplace_back(literals + offsets[i], literals + offsets[i + 1]);
+
+    this->initialize(header.maxVarIndex, options, &image);
+}
+
+void Solver::initialize(int maxVarIndex, const SolverOptions &options, 
+                        const CNFImage *image/*=nullptr*/) {
+
+    this->maxVarIndex = this->nOriginalVars = maxVarIndex;
+    this->options = options;
+    // Counting visits both branches of every decision, so nothing may 
+    // prune, merge or reorder models
+    if (options.counting) {
+        this->options.enumeration = true;
+        this->options.sls_interleave = this->options.gauss = false;
+        this->options.chrono_backtrack = this->options.simplify = false;
+        this->options.otf_subsumption = false;
+        // Added variables are not functions of the others
+        this->options.bva = false;
+    }
     this->nConflicts = this->nDecisions = this->nRestarts = 0U;
+    this->nGenerators = this->nSymmetryClauses = 0U;
+    this->nBVAVars = 0U;
+    this->nBVARemovedClauses = 0UL;
+
+    // Breaking symmetries would drop models the caller asked for
+    if (this->options.symmetry_breaking && !this->options.enumeration)
+        this->breakSymmetries();
+    if (this->options.bva)
+        this->addVariables();
+    // Precomputed data of an image is void if the formula was rewritten
+    if (image != nullptr && (this->nSymmetryClauses > 0U || this->nBVAVars > 0U ||
+                             image->getHeader().nClauses != this->clauses.size() ||
+                             image->getHeader().maxVarIndex != this->maxVarIndex))
+        image = nullptr;
+    this->nInputClauses = this->clauses.size();
+    this->formula_hash = (image != nullptr) ? image->getHeader().formula_hash : 
+                                              hashFormula(this->clauses, this->maxVarIndex);
+
+    this->nLocalSearches = 0U;
+    this->nChronoBacktracks = this->nKeptAssignments = 0UL;
     this->nextRestart = this->luby.next();
+    this->nAllConflicts = 0UL;
+    this->simplify_pending = false;
+    this->nStrengthenedAntecedents = this->nStrengthenedConflicts = 0UL;
+    this->nRootAssignedAtSimplify = 0UL;
+    this->nSimplifications = 0U;
+    this->nRemovedClauses = this->nRemovedLiterals = 0UL;
+    this->aborted = false;
+    this->trace = Tracer::local();
+    this->deadline = std::chrono::steady_clock::now() +
+                     std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(options.time_budget));
 
     // To prevent reallocation of vector which makes pointer to clause invaild
     this->clauses_capacity = CLAUSES_CAPACITY_MULTIPLIER * this->clauses.size();
     this->clauses.reserve(this->clauses_capacity);
-    this->assigned_levels_reverse.resize(maxVarIndex + 1, -1);
-    this->assigned_levels.resize(maxVarIndex + 1);
-    this->assignments.resize(maxVarIndex + 1, UNASSIGNED);
-    this->pos_watched.resize(maxVarIndex + 1);
-    this->neg_watched.resize(maxVarIndex + 1);
-    this->selector = new VSIDS(clauses, maxVarIndex, &this->assignments, &this->nConflicts);
+    this->assigned_levels_reverse.resize(this->maxVarIndex + 1, -1);
+    this->assigned_levels.resize(this->maxVarIndex + 1);
+    this->assignments.resize(this->maxVarIndex + 1, UNASSIGNED);
+    this->pos_watched.resize(this->maxVarIndex + 1);
+    this->neg_watched.resize(this->maxVarIndex + 1);
+    this->phases.resize(this->maxVarIndex + 1, UNASSIGNED);
+    if (options.lookahead)
+        this->selector = new Lookahead(this->clauses, this->maxVarIndex, &this->assignments);
+    else if (options.branching == BRANCH_LRB)
+        this->selector = new LRB(this->maxVarIndex, &this->assignments);
+    else if (options.branching == BRANCH_JW)
+        this->selector = new Jeroslaw_Wang(this->clauses, this->maxVarIndex, &this->assignments);
+    else if (options.branching == BRANCH_BANDIT)
+        this->selector = new Bandit({new VSIDS(this->clauses, this->maxVarIndex, &this->assignments, &this->nConflicts),
+                                     new LRB(this->maxVarIndex, &this->assignments),
+                                     new Jeroslaw_Wang(this->clauses, this->maxVarIndex, &this->assignments)});
+    else if (image != nullptr)
+        this->selector = new VSIDS(image->getOccurrences(), this->maxVarIndex, 
+                                   &this->assignments, &this->nConflicts);
+    else
+        this->selector = new VSIDS(this->clauses, this->maxVarIndex, &this->assignments, &this->nConflicts);
+    // Only the original clauses are visible to local search
+    this->sls = this->options.sls_interleave ? new ProbSAT(this->clauses, this->maxVarIndex) : nullptr;
+    this->sls_pending = this->options.sls_interleave;
+    this->sls_stale = false;
+    this->use_saved_phases = this->options.sls_interleave;
+    this->gauss = nullptr;
+    this->nGaussImplications = this->nGaussConflicts = 0UL;
+    if (this->options.gauss) {
+        auto xors = Gauss::detectXORs(this->clauses);
+        if (!xors.empty()) {
+            this->gauss = new Gauss(xors, this->maxVarIndex);
+            this->gauss_reasons.resize(this->maxVarIndex + 2);
+        }
+    }
+
+    this->nAssigned = 0;
+    this->truth_table_slots.resize(this->maxVarIndex + 1, -1);
+    this->nTruthTables = this->nTruthTableConflicts = 0UL;
+    this->cache = nullptr;
+    this->nComponents = 0UL;
+    if (this->options.counting) {
+        this->cache = new ComponentCache(this->options.count_cache_mb << 20);
+        this->component_roots.resize(this->maxVarIndex + 1);
+        this->component_occurrences.resize(this->maxVarIndex + 1, 0);
+    }
 
     // Construct Watching Lists
+    this->has_empty_clause = false;
     for (auto &clause : this->clauses) {
+        if (clause.empty()) {
+            this->has_empty_clause = true;
+            continue;
+        }
         this->constructWatchingLists(clause);
     }
 }
@@ -41,10 +176,15 @@ void Solver::assign(int var, const clause_t *clause, int level/*=0*/) {
               << var << " on level " << level << "\n";
 #endif
 
+    if (this->assignments[std::abs(var)] == UNASSIGNED)
+        this->nAssigned++;
     this->assignments[std::abs(var)] = (var > 0) ? TRUE : FALSE;
     this->assigned_levels_reverse[std::abs(var)] = level;
     this->assigned_levels[level].emplace_back(var, clause);
     this->imply_queue.push(var);
+    this->selector->onAssign(var);
+    if (this->gauss != nullptr)
+        this->gauss->assign(var);
 }
 
 void Solver::unassign(int level) {
@@ -67,11 +207,19 @@ void Solver::unassign(int level) {
         // the only one variable of it is assigned at level 0, 
         // so the variable cannnot be unassigned  
         if (!assigned_vars_in_level_0.count(assigned.first)) {
+            if (this->assignments[std::abs(assigned.first)] != UNASSIGNED)
+                this->nAssigned--;
+            this->phases[std::abs(assigned.first)] = this->assignments[std::abs(assigned.first)];
             this->assignments[std::abs(assigned.first)] = UNASSIGNED;
             this->assigned_levels_reverse[std::abs(assigned.first)] = -1;
+            this->selector->onUnassign(assigned.first);
+            if (this->gauss != nullptr)
+                this->gauss->unassign(assigned.first);
         }
     }
     this->assigned_levels[level].clear();
+    if (this->gauss != nullptr)
+        this->gauss_reasons[level].clear();
 }
 
 bool Solver::isWatched(const clause_t *clause, int x) const {
@@ -126,69 +274,199 @@ int Solver::BCP(int x, int level) {
 
             // Case 2
             if (assignment == UNASSIGNED) {
-                this->assign(other_watched_var, clause, level);
+                this->assign(other_watched_var, clause, this->impliedLevel(clause, other_watched_var, level));
             }
             // Case 4
             else if ((assignment == FALSE && other_watched_var > 0) ||
                      (assignment == TRUE  && other_watched_var < 0)) {
+                return this->analyze(clause, level);
+            }
+            // Case 3
+            else {}
+            ++it;
+        }
+    }
+    return SUCCESS;
+}
 
-                // Run 1UIP to get newly learned clause and decide jump level
-                clause_t learned_clause = this->FirstUIP(clause, level);
-                if (learned_clause.size() > MIN_LEN_OF_LEARNED_CLAUSE || 
-                    this->clauses.size() >= this->clauses_capacity)
-                    return ECONFLICT;
+int Solver::impliedLevel(const clause_t *clause, int x, int level) const {
 
-                if (++this->nConflicts == this->nextRestart) {
-                    this->nRestarts++;
-                    this->nextRestart += this->luby.next();
-                    this->imply_queue = {};
-#ifdef DEBUG
-                    std::clog << "Restart #" << this->nRestarts << "\n";
-#endif
-                    this->jump_to = 0;
-                    return ECONFLICT;
-                }
-
-                this->jump_to = INT32_MIN;
-                for (auto var : learned_clause) {
-                    int l = this->assigned_levels_reverse[std::abs(var)];
-                    if (l != level)
-                        this->jump_to = std::max(this->jump_to.value(), l);
-                }
-                this->jump_to = std::max(this->jump_to.value(), 0);
-
-                // Add it to database
-                assert("Learned clause should not be empty" && !learned_clause.empty());
-                this->clauses.push_back(learned_clause);
-
-                // Update score table
-                this->selector->update(learned_clause);
-
-                // Update some variables associated with 2-literals watching
-                this->imply_queue = {};
-                constructWatchingLists(this->clauses.back());
-                if (learned_clause.size() > 1) {
-                    int j = 0;
-                    for (size_t i = 0; i < learned_clause.size() && j < 2; ++i) {
-                        if (this->assigned_levels_reverse[std::abs(learned_clause[i])] != level) {
-                            this->imply_queue.push(-learned_clause[i]);
-                            j++;
-                        }
-                    }
-                }
+    if (!this->options.chrono_backtrack)
+        return level;
+
+    // The trail may hold levels out of order, so the implication belongs to
+    // the highest level among the other (falsified) literals
+    int implied_level = 0;
+    for (auto y : *clause)
+        if (y != x)
+            implied_level = std::max(implied_level, this->assigned_levels_reverse[std::abs(y)]);
+    return implied_level;
+}
+
+int Solver::analyze(const clause_t *conflicting_clause, int level) {
+
+    // Conflict on the root level, so the formula is UNSAT
+    if (level == 0) {
+        this->imply_queue = {};
+        return ECONFLICT;
+    }
+    this->nAllConflicts++;
+
+    // Counting needs both branches of every decision, so it neither 
+    // learns nor backjumps
+    if (this->options.counting) {
+        this->nConflicts++;
+        this->imply_queue = {};
+        if (this->trace != nullptr)
+            this->trace->push(TRACE_CONFLICT, level, -1, 0);
+        return ECONFLICT;
+    }
+
+    if (this->options.chrono_backtrack) {
+        int conflict_level = 0;
+        for (auto var : *conflicting_clause)
+            conflict_level = std::max(conflict_level, this->assigned_levels_reverse[std::abs(var)]);
+        // Out-of-order implications can falsify a clause below the current
+        // level. Backtrack there first and let BCP find the conflict again.
+        if (conflict_level < level) {
+            this->imply_queue = {};
+            for (auto var : *conflicting_clause)
+                this->imply_queue.push(-var);
+            this->jump_to = conflict_level;
+            return ECONFLICT;
+        }
+    }
+
+    // Run 1UIP to get newly learned clause and decide jump level
+    clause_t learned_clause = this->FirstUIP(conflicting_clause, level);
+    this->selector->onConflict(this->participants);
+    // The flip of the decision clears the imply queue, so only learning 
+    // backtracks keep strengthened clauses
+    if (learned_clause.size() > MIN_LEN_OF_LEARNED_CLAUSE || 
+        this->clauses.size() >= this->clauses_capacity) {
+        this->subsumed.clear();
+        if (this->trace != nullptr)
+            this->trace->push(TRACE_CONFLICT, level, -1, learned_clause.size());
+        return ECONFLICT;
+    }
+
+    if (++this->nConflicts == this->nextRestart) {
+        this->nRestarts++;
+        if (this->trace != nullptr) {
+            this->trace->push(TRACE_CONFLICT, level, 0, learned_clause.size());
+            this->trace->push(TRACE_RESTART, this->nRestarts, this->nAllConflicts, 
+                              this->assigned_levels[0].size());
+        }
+        this->nextRestart += this->luby.next();
+        this->imply_queue = {};
 #ifdef DEBUG
-                std::clog << "Learned clause: ";
-                std::copy(learned_clause.begin(), learned_clause.end(), 
-                          std::ostream_iterator<int>(std::clog, " "));
-                std::clog << "\nJump to level " << this->jump_to.value() << "\n";
+        std::clog << "Restart #" << this->nRestarts << "\n";
 #endif
-                return ECONFLICT;
+        this->jump_to = 0;
+        this->sls_pending = this->sls != nullptr;
+        this->simplify_pending = this->options.simplify;
+        this->strengthenAntecedents(0);
+        this->selector->onRestart();
+        return ECONFLICT;
+    }
+
+    this->jump_to = INT32_MIN;
+    for (auto var : learned_clause) {
+        int l = this->assigned_levels_reverse[std::abs(var)];
+        if (l != level)
+            this->jump_to = std::max(this->jump_to.value(), l);
+    }
+    this->jump_to = std::max(this->jump_to.value(), 0);
+
+    // Keep the levels in between and imply the asserting literal out of order
+    if (this->options.chrono_backtrack && 
+        level - this->jump_to.value() > this->options.chrono_threshold) {
+        this->nChronoBacktracks++;
+        for (int l = this->jump_to.value() + 1; l < level; ++l)
+            this->nKeptAssignments += this->assigned_levels[l].size();
+        this->jump_to = level - 1;
+    }
+
+    // The learned clause subsumes the conflicting one, which is shrunk to 
+    // it instead of adding a new clause
+    assert("Learned clause should not be empty" && !learned_clause.empty());
+    clause_t *conflicting = this->options.otf_subsumption ? this->inDatabase(conflicting_clause) : nullptr;
+    if (conflicting != nullptr && learned_clause.size() >= 2 && 
+        learned_clause.size() < conflicting->size() &&
+        std::all_of(learned_clause.begin(), learned_clause.end(), [conflicting](int var) {
+            return std::find(conflicting->begin(), conflicting->end(), var) != conflicting->end();
+        })) {
+        this->nStrengthenedConflicts++;
+        size_t i = conflicting - this->clauses.data();
+        if (i >= this->nInputClauses) {
+            std::unordered_set<int> levels;
+            for (auto var : learned_clause)
+                levels.insert(this->assigned_levels_reverse[std::abs(var)]);
+            this->lbds[i - this->nInputClauses] = levels.size();
+        }
+        if (this->trace != nullptr)
+            this->trace->push(TRACE_CONFLICT, level, this->jump_to.value(), learned_clause.size(),
+                              (i >= this->nInputClauses) ? this->lbds[i - this->nInputClauses] : 0);
+        this->sls_stale |= i < this->nInputClauses;
+        *conflicting = learned_clause;
+        this->selector->update(learned_clause);
+        this->imply_queue = {};
+        this->rewatch(*conflicting, this->jump_to.value());
+        this->strengthenAntecedents(this->jump_to.value());
+        return ECONFLICT;
+    }
+
+    // Add it to database
+    this->clauses.push_back(learned_clause);
+    std::unordered_set<int> levels;
+    for (auto var : learned_clause)
+        levels.insert(this->assigned_levels_reverse[std::abs(var)]);
+    this->lbds.push_back(levels.size());
+    if (this->trace != nullptr)
+        this->trace->push(TRACE_CONFLICT, level, this->jump_to.value(), learned_clause.size(), 
+                          levels.size());
+
+    // Update score table
+    this->selector->update(learned_clause);
+
+    // Update some variables associated with 2-literals watching
+    this->imply_queue = {};
+    constructWatchingLists(this->clauses.back());
+    if (learned_clause.size() > 1) {
+        int j = 0;
+        for (size_t i = 0; i < learned_clause.size() && j < 2; ++i) {
+            if (this->assigned_levels_reverse[std::abs(learned_clause[i])] != level) {
+                this->imply_queue.push(-learned_clause[i]);
+                j++;
             }
-            // Case 3
-            else {}
-            ++it;
         }
     }
+    this->strengthenAntecedents(this->jump_to.value());
+#ifdef DEBUG
+    std::clog << "Learned clause: ";
+    std::copy(learned_clause.begin(), learned_clause.end(), 
+              std::ostream_iterator<int>(std::clog, " "));
+    std::clog << "\nJump to level " << this->jump_to.value() << "\n";
+#endif
+    return ECONFLICT;
+}
+
+int Solver::gaussPropagate(int level) {
+
+    std::vector<clause_t> implied;
+    if (!this->gauss->propagate(implied, this->gauss_conflict)) {
+        this->nGaussConflicts++;
+        return this->analyze(&this->gauss_conflict, level);
+    }
+
+    for (auto &reason : implied) {
+        int l = this->impliedLevel(&reason, reason[0], level);
+        // Reasons live as long as the level their literal is assigned on
+        this->gauss_reasons[l].push_back(std::move(reason));
+        const clause_t *clause = &this->gauss_reasons[l].back();
+        this->assign(clause->at(0), clause, l);
+        this->nGaussImplications++;
+    }
     return SUCCESS;
 }
 
@@ -222,25 +500,67 @@ int Solver::isSolved() const {
 
 bool Solver::DPLL(int level/*=0*/) {
 
+    if (this->has_empty_clause)
+        return UNSAT;
+
     while (true) {
 
-        while (!this->imply_queue.empty()) {
-            int var = this->imply_queue.front();
-            this->imply_queue.pop();
-            if(this->BCP(var, level) == ECONFLICT)
+        while (true) {
+            while (!this->imply_queue.empty()) {
+                int var = this->imply_queue.front();
+                this->imply_queue.pop();
+                if(this->BCP(var, level) == ECONFLICT)
+                    return UNSAT;
+            }
+            // XOR constraints are propagated once the clauses reach a fixpoint
+            if (this->gauss == nullptr)
+                break;
+            if (this->gaussPropagate(level) == ECONFLICT)
                 return UNSAT;
+            if (this->imply_queue.empty())
+                break;
+        }
+
+        if (level == 0 && this->simplify_pending) {
+            this->simplify_pending = false;
+            if (this->assigned_levels[0].size() > this->nRootAssignedAtSimplify) {
+                if (!this->simplify())
+                    return UNSAT;
+                // Clauses stripped down to a unit are to be propagated
+                if (!this->imply_queue.empty())
+                    continue;
+            }
+        }
+
+        if (level == 0 && this->sls_pending) {
+            this->sls_pending = false;
+            if (this->localSearch())
+                return SAT;
         }
 
+        if (this->outOfBudget())
+            return UNSAT;
+
+        if (this->options.truth_table && this->maxVarIndex - this->nAssigned <= TRUTH_TABLE_VARS &&
+            this->nAssigned < this->maxVarIndex)
+            return this->truthTable(level);
+
         int next_var = this->selector->getNextDicisionVariable();
         if (next_var == 0)
             return SAT;
         this->nDecisions++;        
+        if (this->use_saved_phases && this->phases[std::abs(next_var)] != UNASSIGNED)
+            next_var = (this->phases[std::abs(next_var)] == TRUE) ? std::abs(next_var) : -std::abs(next_var);
 
+        if (this->trace != nullptr)
+            this->trace->push(TRACE_DECISION, level + 1, next_var);
         this->assign(next_var, nullptr, level + 1);
         if (DPLL(level + 1) == SAT)
             return SAT;
 
         this->unassign(level + 1);
+        if (this->aborted)
+            return UNSAT;
 
         // First time conflict happened but learned no clause
         if (!this->jump_to.has_value()) {
@@ -249,6 +569,8 @@ bool Solver::DPLL(int level/*=0*/) {
             if (DPLL(level + 1) == SAT)
                 return SAT;
             this->unassign(level + 1);
+            if (this->aborted)
+                return UNSAT;
         }
 
         if (this->jump_to.has_value()) {
@@ -268,10 +590,271 @@ bool Solver::DPLL(int level/*=0*/) {
     }
 }
 
+int Solver::truthTable(int level) {
+
+    this->nTruthTables++;
+    std::vector<int> window;
+    for (int var = 1; var <= this->maxVarIndex; ++var) {
+        if (this->assignments[var] == UNASSIGNED) {
+            this->truth_table_slots[var] = window.size();
+            window.push_back(var);
+        }
+    }
+
+    // Bit i of the table is the assignment in which slot s is true iff 
+    // bit s of i is set. The low six slots alternate within a word.
+    static const uint64_t patterns[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    size_t nWords = (window.size() <= 6) ? 1UL : (1UL << (window.size() - 6));
+    std::vector<uint64_t> table(nWords, ~0ULL), satisfied(nWords);
+    if (window.size() < 6)
+        table[0] = (1ULL << (1U << window.size())) - 1ULL;
+
+    // Only clauses over the window can shrink the table, since the others
+    // are satisfied after BCP
+    if (this->truth_table_occurrences.empty()) {
+        this->truth_table_occurrences.resize(this->maxVarIndex + 1);
+        for (size_t i = 0; i < this->nInputClauses; ++i)
+            for (auto x : this->clauses[i])
+                this->truth_table_occurrences[std::abs(x)].push_back(i);
+    }
+    std::vector<size_t> scanned;
+    for (int var : window)
+        scanned.insert(scanned.end(), this->truth_table_occurrences[var].begin(),
+                       this->truth_table_occurrences[var].end());
+    std::sort(scanned.begin(), scanned.end());
+    scanned.erase(std::unique(scanned.begin(), scanned.end()), scanned.end());
+
+    size_t core = 0;
+    bool conflict = false;
+    for (; core < scanned.size() && !conflict; ++core) {
+        const clause_t &clause = this->clauses[scanned[core]];
+        if (std::any_of(clause.begin(), clause.end(), [this](int x) {
+                return this->assignments[std::abs(x)] == ((x > 0) ? TRUE : FALSE);
+            }))
+            continue;
+        std::fill(satisfied.begin(), satisfied.end(), 0ULL);
+        for (auto x : clause) {
+            if (this->assignments[std::abs(x)] != UNASSIGNED)
+                continue;
+            int slot = this->truth_table_slots[std::abs(x)];
+            uint64_t flip = (x > 0) ? 0ULL : ~0ULL;
+            if (slot < 6) {
+                for (auto &word : satisfied)
+                    word |= patterns[slot] ^ flip;
+            }
+            else {
+                for (size_t w = 0; w < nWords; ++w)
+                    satisfied[w] |= (((w >> (slot - 6)) & 1UL) ? ~0ULL : 0ULL) ^ flip;
+            }
+        }
+        uint64_t alive = 0ULL;
+        for (size_t w = 0; w < nWords; ++w)
+            alive |= (table[w] &= satisfied[w]);
+        conflict = (alive == 0ULL);
+    }
+
+    for (int var : window)
+        this->truth_table_slots[var] = -1;
+
+    if (!conflict) {
+        size_t w = 0;
+        while (table[w] == 0ULL)
+            ++w;
+        uint64_t model = (w << 6) | __builtin_ctzll(table[w]);
+        for (size_t slot = 0; slot < window.size(); ++slot)
+            this->assign(((model >> slot) & 1ULL) ? window[slot] : -window[slot], nullptr, level + 1);
+        return SAT;
+    }
+
+    // The clauses up to the one emptying the table are unsatisfiable under
+    // the trail, so their falsified literals form an implied clause
+    this->nTruthTableConflicts++;
+    clause_t conflicting;
+    for (size_t i = 0; i < core; ++i) {
+        const clause_t &clause = this->clauses[scanned[i]];
+        if (std::any_of(clause.begin(), clause.end(), [this](int x) {
+                return this->assignments[std::abs(x)] == ((x > 0) ? TRUE : FALSE);
+            }))
+            continue;
+        for (auto x : clause)
+            if (this->assignments[std::abs(x)] != UNASSIGNED &&
+                std::find(conflicting.begin(), conflicting.end(), x) == conflicting.end())
+                conflicting.push_back(x);
+    }
+
+    // 1UIP needs a literal on this level; otherwise flip chronologically
+    if (std::none_of(conflicting.begin(), conflicting.end(), [this, level](int x) {
+            return this->assigned_levels_reverse[std::abs(x)] == level;
+        })) {
+        this->imply_queue = {};
+        return UNSAT;
+    }
+    this->analyze(&conflicting, level);
+    return UNSAT;
+}
+
+bool Solver::outOfBudget() {
+    if (this->options.conflict_budget != 0UL &&
+        this->nAllConflicts >= this->options.conflict_budget)
+        this->aborted = true;
+    // Reading the clock on every decision would be noticeable
+    else if (this->options.time_budget > 0.0 && (this->nDecisions & 63U) == 0U &&
+             std::chrono::steady_clock::now() > this->deadline)
+        this->aborted = true;
+    return this->aborted;
+}
+
+BigNum Solver::count() {
+
+    if (this->has_empty_clause || !this->propagateCount(0))
+        return BigNum();
+
+    component_t formula;
+    for (int var = 1; var <= this->maxVarIndex; ++var)
+        formula.vars.push_back(var);
+    for (size_t i = 0; i < this->nInputClauses; ++i)
+        formula.clauses.push_back(i);
+
+    std::vector<component_t> components;
+    BigNum models(1ULL);
+    models <<= this->decompose(formula, components);
+    for (const auto &component : components) {
+        models = models * this->countComponent(component, 0);
+        if (models.isZero() || this->aborted)
+            break;
+    }
+    return this->aborted ? BigNum() : models;
+}
+
+bool Solver::propagateCount(int level) {
+    while (!this->imply_queue.empty()) {
+        int var = this->imply_queue.front();
+        this->imply_queue.pop();
+        if (this->BCP(var, level) == ECONFLICT)
+            return false;
+    }
+    return true;
+}
+
+size_t Solver::decompose(const component_t &component, std::vector<component_t> &components) {
+
+    auto find = [this](int var) {
+        while (this->component_roots[var] != var)
+            var = this->component_roots[var] = this->component_roots[this->component_roots[var]];
+        return var;
+    };
+
+    for (int var : component.vars)
+        this->component_roots[var] = var;
+
+    // Union the unassigned variables of each unsatisfied clause
+    std::vector<uint32_t> active;
+    for (uint32_t i : component.clauses) {
+        const clause_t &clause = this->clauses[i];
+        bool satisfied = std::any_of(clause.begin(), clause.end(), [this](int x) {
+            return this->assignments[std::abs(x)] == ((x > 0) ? TRUE : FALSE);
+        });
+        if (satisfied)
+            continue;
+        active.push_back(i);
+        int first = 0;
+        for (auto x : clause) {
+            if (this->assignments[std::abs(x)] != UNASSIGNED)
+                continue;
+            this->component_occurrences[std::abs(x)]++;
+            if (first == 0)
+                first = std::abs(x);
+            else
+                this->component_roots[find(std::abs(x))] = find(first);
+        }
+    }
+
+    // Variables and clauses are visited in order, so both stay sorted
+    size_t nFree = 0UL;
+    std::unordered_map<int, size_t> index;
+    for (int var : component.vars) {
+        if (this->assignments[var] != UNASSIGNED)
+            continue;
+        if (this->component_occurrences[var] == 0) {
+            nFree++;
+            continue;
+        }
+        this->component_occurrences[var] = 0;
+        auto found = index.emplace(find(var), components.size());
+        if (found.second)
+            components.emplace_back();
+        components[found.first->second].vars.push_back(var);
+    }
+    for (uint32_t i : active) {
+        for (auto x : this->clauses[i]) {
+            if (this->assignments[std::abs(x)] == UNASSIGNED) {
+                components[index.at(find(std::abs(x)))].clauses.push_back(i);
+                break;
+            }
+        }
+    }
+    this->nComponents += components.size();
+    return nFree;
+}
+
+BigNum Solver::countComponent(const component_t &component, int level) {
+
+    std::vector<uint32_t> key(component.vars.begin(), component.vars.end());
+    key.push_back(UINT32_MAX);
+    key.insert(key.end(), component.clauses.begin(), component.clauses.end());
+    if (const BigNum *cached = this->cache->lookup(key))
+        return *cached;
+
+    if (this->outOfBudget())
+        return BigNum();
+
+    // Branch on the variable occurring most in the component
+    for (uint32_t i : component.clauses)
+        for (auto x : this->clauses[i])
+            if (this->assignments[std::abs(x)] == UNASSIGNED)
+                this->component_occurrences[std::abs(x)]++;
+    int next_var = component.vars[0];
+    for (int var : component.vars) {
+        if (this->component_occurrences[var] > this->component_occurrences[next_var])
+            next_var = var;
+    }
+    for (int var : component.vars)
+        this->component_occurrences[var] = 0;
+
+    BigNum models;
+    for (int literal : {next_var, -next_var}) {
+        this->nDecisions++;
+        if (this->trace != nullptr)
+            this->trace->push(TRACE_DECISION, level + 1, literal);
+        this->assign(literal, nullptr, level + 1);
+        if (this->propagateCount(level + 1)) {
+            std::vector<component_t> components;
+            BigNum branch(1ULL);
+            branch <<= this->decompose(component, components);
+            for (const auto &residual : components) {
+                branch = branch * this->countComponent(residual, level + 1);
+                if (branch.isZero() || this->aborted)
+                    break;
+            }
+            models += branch;
+        }
+        this->unassign(level + 1);
+        this->imply_queue = {};
+        if (this->aborted)
+            return BigNum();
+    }
+
+    this->cache->store(key, models);
+    return models;
+}
+
 std::vector<int> Solver::getAssignments() const {
     std::vector<int> assignments;
-    assignments.resize(this->maxVarIndex);
-    for (size_t i = 1; i < this->assignments.size(); ++i)
+    assignments.resize(this->nOriginalVars);
+    for (int i = 1; i <= this->nOriginalVars; ++i)
         assignments[i - 1] = (this->assignments[i] == TRUE) ? i : -i;
     return assignments;
 }
@@ -292,9 +875,11 @@ clause_t Solver::resolve(const clause_t *F, const clause_t *G, int x) {
     return clause;
 }
 
-clause_t Solver::FirstUIP(const clause_t *conflicting_clause, int level) const {
+clause_t Solver::FirstUIP(const clause_t *conflicting_clause, int level) {
 
     clause_t C = *conflicting_clause;
+    this->subsumed.clear();
+    this->participants.assign(C.begin(), C.end());
     int current_decision_var = this->assigned_levels.at(level).at(0).first;
 
     while (true) {
@@ -329,10 +914,63 @@ clause_t Solver::FirstUIP(const clause_t *conflicting_clause, int level) const {
         assert("p should not be 0" && p != 0);
 
         C = this->resolve(&C, antecedent, p);
+        this->participants.insert(this->participants.end(), antecedent->begin(), antecedent->end());
+
+        // On-the-fly subsumption [Han and Somenzi, 2009]: the resolvent 
+        // holds the rest of the antecedent, so if it is one literal shorter 
+        // the antecedent minus p is the resolvent itself
+        if (this->options.otf_subsumption && C.size() >= 2 && C.size() + 1 == antecedent->size() &&
+            this->inDatabase(antecedent) != nullptr &&
+            std::all_of(C.begin(), C.end(), [antecedent](int var) {
+                return std::find(antecedent->begin(), antecedent->end(), var) != antecedent->end();
+            }))
+            this->subsumed.emplace_back(antecedent, p);
     }
     return C;
 }
 
+clause_t *Solver::inDatabase(const clause_t *clause) {
+    if (clause < this->clauses.data() || clause >= this->clauses.data() + this->clauses.size())
+        return nullptr;
+    return &this->clauses[clause - this->clauses.data()];
+}
+
+void Solver::strengthenAntecedents(int jump_level) {
+    for (const auto &candidate : this->subsumed) {
+        clause_t &clause = *this->inDatabase(candidate.first);
+        this->sls_stale |= static_cast<size_t>(&clause - this->clauses.data()) < this->nInputClauses;
+        clause.erase(std::find(clause.begin(), clause.end(), candidate.second));
+        this->rewatch(clause, jump_level);
+        this->nStrengthenedAntecedents++;
+    }
+    this->subsumed.clear();
+}
+
+void Solver::rewatch(clause_t &clause, int jump_level) {
+
+    auto &watched_vars = this->watched_variable[&clause];
+    for (int var : {watched_vars.first, watched_vars.second})
+        if (var != 0)
+            ((var > 0) ? this->pos_watched[var] : this->neg_watched[-var]).remove(&clause);
+
+    // The literals were false on conflict, but a learned unit may have made 
+    // one true since; otherwise the ones assigned last are unassigned first
+    auto rank = [this](int var) {
+        return this->isTrue(var) ? INT32_MAX : this->assigned_levels_reverse[std::abs(var)];
+    };
+    std::partial_sort(clause.begin(), clause.begin() + 2, clause.end(), [&rank](int a, int b) {
+        return rank(a) > rank(b);
+    });
+    for (int i = 0; i < 2; ++i)
+        ((clause[i] > 0) ? this->pos_watched[clause[i]] : this->neg_watched[-clause[i]]).push_back(&clause);
+    watched_vars = {clause[0], clause[1]};
+
+    // Only clause[0] is unassigned by the backtrack, so clause is unit
+    if (!this->isTrue(clause[0]) && !this->isTrue(clause[1]) &&
+        this->assigned_levels_reverse[std::abs(clause[1])] <= jump_level)
+        this->imply_queue.push(-clause[1]);
+}
+
 void Solver::constructWatchingLists(const clause_t &clause) {
 
     int var1 = clause[0];
@@ -343,6 +981,12 @@ void Solver::constructWatchingLists(const clause_t &clause) {
     
     if (clause.size() < 2) {
         this->watched_variable[&clause] = {var1, 0};
+        // Contradicts another unit, so the formula is UNSAT
+        if (this->assigned_levels_reverse[std::abs(var1)] == 0 &&
+            this->assignments[std::abs(var1)] != ((var1 > 0) ? TRUE : FALSE)) {
+            this->has_empty_clause = true;
+            return;
+        }
         this->assign(var1, &clause);
         return;
     }
@@ -355,9 +999,195 @@ void Solver::constructWatchingLists(const clause_t &clause) {
     this->watched_variable[&clause] = {var1, var2};
 }
 
+bool Solver::simplify() {
+
+    this->nSimplifications++;
+    size_t nKept = 0, nKeptInput = 0;
+    size_t nClausesBefore = this->clauses.size();
+    unsigned long nRemovedLiteralsBefore = this->nRemovedLiterals;
+    std::vector<unsigned> kept_lbds;
+    for (size_t i = 0; i < this->clauses.size(); ++i) {
+        clause_t &clause = this->clauses[i];
+        bool satisfied = false;
+        size_t size = 0;
+        for (auto var : clause) {
+            int assignment = this->assignments[std::abs(var)];
+            if (assignment == UNASSIGNED)
+                clause[size++] = var;
+            else if ((assignment == TRUE) == (var > 0)) {
+                satisfied = true;
+                break;
+            }
+        }
+        if (satisfied) {
+            this->nRemovedClauses++;
+            continue;
+        }
+        this->nRemovedLiterals += clause.size() - size;
+        clause.resize(size);
+        if (clause.empty()) {
+            this->has_empty_clause = true;
+            return false;
+        }
+        if (i < this->nInputClauses)
+            nKeptInput++;
+        else
+            kept_lbds.push_back(this->lbds[i - this->nInputClauses]);
+        if (nKept != i)
+            this->clauses[nKept] = std::move(clause);
+        nKept++;
+    }
+    // Erasing keeps the capacity, so the clauses are not reallocated later
+    this->clauses.erase(this->clauses.begin() + nKept, this->clauses.end());
+    this->nInputClauses = nKeptInput;
+    this->truth_table_occurrences.clear();
+    this->lbds.swap(kept_lbds);
+
+    // Root assignments are never resolved on, and their reasons may be gone
+    for (auto &assigned : this->assigned_levels[0])
+        assigned.second = nullptr;
+    for (int var = 1; var <= this->maxVarIndex; ++var) {
+        this->pos_watched[var].clear();
+        this->neg_watched[var].clear();
+    }
+    this->watched_variable.clear();
+    for (auto &clause : this->clauses)
+        this->constructWatchingLists(clause);
+
+    if (this->sls != nullptr) {
+        delete this->sls;
+        this->sls = new ProbSAT(this->clauses, this->maxVarIndex, 1, this->nInputClauses);
+        this->sls_stale = false;
+    }
+    this->nRootAssignedAtSimplify = this->assigned_levels[0].size();
+    if (this->trace != nullptr)
+        this->trace->push(TRACE_REDUCTION, nKept, nClausesBefore - nKept, 
+                          this->nRemovedLiterals - nRemovedLiteralsBefore, 
+                          this->nRootAssignedAtSimplify);
+
+#ifdef DEBUG
+    std::clog << "Simplification #" << this->nSimplifications << " kept " << nKept 
+              << " clauses\n";
+#endif
+    return true;
+}
+
+void Solver::breakSymmetries() {
+
+    Symmetry symmetry(this->clauses, this->maxVarIndex);
+    auto generators = symmetry.findGenerators();
+    auto sbp = Symmetry::lexLeader(generators, this->maxVarIndex, this->nOriginalVars);
+
+#ifdef DEBUG
+    std::clog << "Found " << generators.size() << " symmetry generators in " 
+              << symmetry.getWork() << " refinement steps\n";
+#endif
+
+    this->nGenerators = generators.size();
+    this->nSymmetryClauses = sbp.size();
+    std::move(sbp.begin(), sbp.end(), std::back_inserter(this->clauses));
+}
+
+void Solver::addVariables() {
+
+    BVA bva(this->clauses, this->maxVarIndex);
+    this->maxVarIndex = bva.run();
+
+#ifdef DEBUG
+    std::clog << "Added " << bva.getNumAddedVars() << " variables and removed " 
+              << bva.getNumRemovedClauses() << " clauses in " << bva.getWork() << " steps\n";
+#endif
+
+    this->nBVAVars = bva.getNumAddedVars();
+    this->nBVARemovedClauses = bva.getNumRemovedClauses();
+}
+
+bool Solver::localSearch() {
+
+    std::vector<bool> initial(this->maxVarIndex + 1, false);
+    std::vector<bool> fixed(this->maxVarIndex + 1, false);
+    for (int var = 1; var <= this->maxVarIndex; ++var) {
+        if (this->assignments[var] != UNASSIGNED) {
+            initial[var] = (this->assignments[var] == TRUE);
+            fixed[var] = true;
+        }
+        else
+            initial[var] = (this->phases[var] == TRUE);
+    }
+
+    if (this->sls_stale) {
+        delete this->sls;
+        this->sls = new ProbSAT(this->clauses, this->maxVarIndex, 1, this->nInputClauses);
+        this->sls_stale = false;
+    }
+    this->nLocalSearches++;
+    bool found = this->sls->solve(initial, fixed, this->options.sls_flips);
+    const std::vector<bool> &best = this->sls->getBestAssignment();
+
+#ifdef DEBUG
+    std::clog << "Local search #" << this->nLocalSearches 
+              << (found ? " found a model\n" : " failed\n");
+#endif
+
+    for (int var = 1; var <= this->maxVarIndex; ++var) {
+        if (found)
+            this->assignments[var] = best[var] ? TRUE : FALSE;
+        else if (!fixed[var])
+            this->phases[var] = best[var] ? TRUE : FALSE;
+    }
+    return found;
+}
+
 void Solver::printStatistics() const {
     std::clog << "\nrestarts              : " << this->nRestarts
               << "\nconflicts             : " << this->nConflicts
               << "\ndecisions             : " << this->nDecisions
               << "\n";
+    if (const Bandit *bandit = dynamic_cast<const Bandit *>(this->selector)) {
+        std::clog << "epochs per heuristic  : ";
+        std::copy(bandit->getPulls().begin(), bandit->getPulls().end(),
+                  std::ostream_iterator<unsigned>(std::clog, " "));
+        std::clog << "(VSIDS LRB JW)\n";
+    }
+    if (this->options.simplify)
+        std::clog << "simplifications       : " << this->nSimplifications
+                  << "\nremoved clauses       : " << this->nRemovedClauses
+                  << "\nremoved literals      : " << this->nRemovedLiterals
+                  << "\n";
+    if (this->options.otf_subsumption)
+        std::clog << "strengthened clauses  : " << this->nStrengthenedAntecedents
+                  << "\nsubsumed conflicts    : " << this->nStrengthenedConflicts
+                  << "\n";
+    if (this->options.chrono_backtrack)
+        std::clog << "chrono backtracks     : " << this->nChronoBacktracks
+                  << "\nkept assignments      : " << this->nKeptAssignments
+                  << "\n";
+    if (this->gauss != nullptr)
+        std::clog << "XOR constraints       : " << this->gauss->getNumRows()
+                  << "\ngauss eliminations    : " << this->gauss->getPropagations()
+                  << "\nXOR implications      : " << this->nGaussImplications
+                  << "\nXOR conflicts         : " << this->nGaussConflicts
+                  << "\n";
+    if (this->options.symmetry_breaking)
+        std::clog << "symmetry generators   : " << this->nGenerators
+                  << "\nsymmetry clauses      : " << this->nSymmetryClauses
+                  << "\n";
+    if (this->options.truth_table)
+        std::clog << "truth tables          : " << this->nTruthTables
+                  << "\ntruth table conflicts : " << this->nTruthTableConflicts
+                  << "\n";
+    if (this->cache != nullptr)
+        std::clog << "components            : " << this->nComponents
+                  << "\ncache hits            : " << this->cache->getHits()
+                  << "\ncache misses          : " << this->cache->getMisses()
+                  << "\ncache flushes         : " << this->cache->getFlushes()
+                  << "\n";
+    if (this->options.bva)
+        std::clog << "added variables       : " << this->nBVAVars
+                  << "\nremoved clauses (BVA) : " << this->nBVARemovedClauses
+                  << "\n";
+    if (this->sls != nullptr)
+        std::clog << "local searches        : " << this->nLocalSearches
+                  << "\nflips                 : " << this->sls->getFlips()
+                  << "\n";
 }
\ No newline at end of file
@@ -7,14 +7,83 @@
 #include <queue>
 #include <utility>
 #include <optional>
+#include <deque>
+#include <chrono>
 
 #include "VSIDS.hpp"
+#include "Lookahead.hpp"
+#include "LRB.hpp"
+#include "Jeroslaw_Wang.hpp"
+#include "Bandit.hpp"
 #include "Luby.hpp"
+#include "ProbSAT.hpp"
+#include "Gauss.hpp"
+#include "Symmetry.hpp"
+#include "BVA.hpp"
+#include "ycnf.hpp"
+#include "trace.hpp"
+#include "BigNum.hpp"
+#include "ComponentCache.hpp"
 
 typedef std::vector<int> clause_t;
 
+/// Residual formulas over at most this many variables are evaluated by 
+/// truth tables of 2^TRUTH_TABLE_VARS bits
+#define TRUTH_TABLE_VARS 16
+
+/// Branching heuristic deciding the variables
+enum branching_t {
+    BRANCH_VSIDS, BRANCH_LRB, BRANCH_JW,
+    /// Switch among the three every BANDIT_EPOCH conflicts
+    BRANCH_BANDIT
+};
+
+/// Runtime configuration of @c Solver
+struct SolverOptions {
+    /// Run ProbSAT before the first decision and at every restart
+    bool sls_interleave = false;
+    /// Flip budget of each local search run
+    unsigned long sls_flips = 1000000UL;
+    /// Backtrack only one level when the jump would undo more than
+    /// @c chrono_threshold levels
+    bool chrono_backtrack = false;
+    int chrono_threshold = 100;
+    /// Detect XOR constraints and propagate them by Gauss-Jordan elimination
+    bool gauss = false;
+    /// Add lex-leader clauses breaking the symmetries of the formula
+    bool symmetry_breaking = false;
+    /// Every model will be enumerated, so no model may be excluded
+    bool enumeration = false;
+    /// Replace bicliques of clauses, such as pairwise at-most-one 
+    /// constraints, by fewer clauses over added variables
+    bool bva = false;
+    /// Give up after this many conflicts (0 for no limit)
+    unsigned long conflict_budget = 0UL;
+    /// Give up after this many seconds since construction (0 for no limit)
+    double time_budget = 0.0;
+    /// Drop satisfied clauses and root-false literals at restarts once 
+    /// new root units have appeared
+    bool simplify = true;
+    /// Strengthen the clauses subsumed by resolvents during conflict analysis
+    bool otf_subsumption = true;
+    /// Count the models with @c Solver::count instead of finding one, 
+    /// which turns off every technique that prunes or merges models
+    bool counting = false;
+    /// Memory budget of the component cache of counting, in MiB
+    size_t count_cache_mb = 256UL;
+    /// Decide the residual formula by its truth table once at most 
+    /// @c TRUTH_TABLE_VARS variables are unassigned
+    bool truth_table = true;
+    branching_t branching = BRANCH_VSIDS;
+    /// Decide by lookahead instead, which suits small hard instances
+    bool lookahead = false;
+};
+
 class Solver {
 
+    /// Microbenchmarks in bench/ drive the kernels directly
+    friend class SolverBench;
+
     enum {
         ECONFLICT, SUCCESS
     };
@@ -30,8 +99,18 @@ class Solver {
 private:
 
     int maxVarIndex;
+    /// Variables after it are auxiliary ones added by preprocessing
+    int nOriginalVars;
     size_t clauses_capacity;
     std::vector<clause_t> clauses;
+    /// The input contains an empty clause, so it is trivially UNSAT
+    bool has_empty_clause;
+    /// Clauses after the first nInputClauses ones are learned
+    size_t nInputClauses;
+    /// Literal block distance of each learned clause
+    std::vector<unsigned> lbds;
+    /// Hash of the clauses the solver starts with, to validate snapshots
+    uint64_t formula_hash;
     /// Final answer
     std::vector<int> assignments;
     /// The index is level and value is a vector storing pairs of a variable 
@@ -54,16 +133,112 @@ private:
     unsigned nDecisions;
     unsigned nConflicts;
     unsigned nRestarts;
+    /// Every conflict, also those whose learned clause is dropped, 
+    /// counted against the conflict budget
+    unsigned long nAllConflicts;
+    /// Set once the budget is exhausted, which unwinds DPLL
+    bool aborted;
+    std::chrono::steady_clock::time_point deadline;
     /// Random restart
     Luby luby;
     unsigned nextRestart;
+    SolverOptions options;
+    /// Stochastic local search interleaved with CDCL
+    ProbSAT *sls;
+    /// Set when local search should run once the root level is propagated
+    bool sls_pending;
+    /// Set when an input clause was strengthened, which voids the 
+    /// occurrence lists of @c sls
+    bool sls_stale;
+    unsigned nLocalSearches;
+    /// Chronological backtracking and the assignments it did not undo
+    unsigned long nChronoBacktracks;
+    unsigned long nKeptAssignments;
+    /// Gauss-Jordan elimination on the detected XOR constraints
+    Gauss *gauss;
+    /// The index is level and value is reasons of XOR implications on it
+    std::vector<std::deque<clause_t> > gauss_reasons;
+    clause_t gauss_conflict;
+    unsigned long nGaussImplications;
+    unsigned long nGaussConflicts;
+    /// Symmetry breaking
+    unsigned nGenerators;
+    unsigned nSymmetryClauses;
+    /// Bounded variable addition
+    unsigned nBVAVars;
+    size_t nBVARemovedClauses;
+    /// Root-level simplification, run when @c simplify_pending is set by 
+    /// a restart and the root level grew since the last run
+    bool simplify_pending;
+    size_t nRootAssignedAtSimplify;
+    unsigned nSimplifications;
+    unsigned long nRemovedClauses;
+    unsigned long nRemovedLiterals;
+    /// Antecedents (and the literal resolved on) which an intermediate 
+    /// resolvent of the last @c FirstUIP subsumes
+    std::vector<std::pair<const clause_t *, int> > subsumed;
+    /// Variables of the clauses the last @c FirstUIP resolved
+    std::vector<int> participants;
+    /// Model counting: a component is a set of unassigned variables and 
+    /// the unsatisfied input clauses connecting them
+    struct component_t {
+        std::vector<int> vars;
+        std::vector<uint32_t> clauses;
+    };
+    ComponentCache *cache;
+    /// Union-find forest and occurrence counts, indexed by variable
+    std::vector<int> component_roots;
+    std::vector<int> component_occurrences;
+    unsigned long nComponents;
+    /// Variables not UNASSIGNED, kept by @c assign and @c unassign
+    int nAssigned;
+    /// Position of each unassigned variable in the truth table window
+    std::vector<int> truth_table_slots;
+    /// Input clauses each variable occurs in, built by the first truth 
+    /// table and dropped when simplification moves the clauses
+    std::vector<std::vector<size_t> > truth_table_occurrences;
+    unsigned long nTruthTables;
+    unsigned long nTruthTableConflicts;
+    /// Ring of the solving thread when tracing is on, nullptr otherwise
+    TraceRing *trace;
+    unsigned long nStrengthenedAntecedents;
+    unsigned long nStrengthenedConflicts;
+    /// Saved phases (TRUE, FALSE or UNASSIGNED) of decision variables
+    std::vector<int> phases;
+    /// Decide on the saved phase instead of the heuristic's one
+    bool use_saved_phases;
 
 public:
 
-    Solver(std::vector<clause_t> &clauses, int maxVarIndex);
+    Solver(std::vector<clause_t> &clauses, int maxVarIndex,
+           const SolverOptions &options=SolverOptions());
+
+    /// Take over @c clauses without copying them
+    Solver(std::vector<clause_t> &&clauses, int maxVarIndex,
+           const SolverOptions &options=SolverOptions());
+
+    /**
+     * @brief Build the clause database straight from a flat buffer of 
+     *        zero-terminated clauses, e.g. {1, -2, 0, 2, 3, 0}
+     * @param[in] maxVarIndex Computed from the buffer if negative
+     */
+    Solver(const int *literals, size_t nLiterals, int maxVarIndex=-1,
+           const SolverOptions &options=SolverOptions());
+
+    /**
+     * @brief Build the clause database from a compiled image, taking the 
+     *        formula hash and VSIDS occurrence counts precomputed in it
+     */
+    explicit Solver(const CNFImage &image, const SolverOptions &options=SolverOptions());
+
+    Solver(const Solver &) = delete;
+    Solver &operator=(const Solver &) = delete;
 
     ~Solver() {
         delete this->selector;
+        delete this->sls;
+        delete this->gauss;
+        delete this->cache;
     }
 
     /**
@@ -75,18 +250,69 @@ public:
     bool DPLL(int level=0);
 
     /**
-     * @brief Convert the final assignments to DIMACS format
+     * @brief Exact number of models over variables 1..maxVarIndex, by DPLL which 
+     *        splits the residual formula into connected components and 
+     *        caches their counts. Requires @c SolverOptions::counting.
+     * @return Zero if UNSAT, or if the budget ran out (see @c isAborted)
+     */
+    BigNum count();
+
+    /**
+     * @return true if DPLL gave up because the budget ran out, in which 
+     *         case its result means UNKNOWN
+     */
+    bool isAborted() const {
+        return this->aborted;
+    }
+
+    /**
+     * @brief Convert the final assignments of the original variables 
+     *        to DIMACS format
      */
     std::vector<int> getAssignments() const;
 
+    /**
+     * @brief Hand over the clause database, learned clauses included, so 
+     *        that its buffers can be refilled with the next formula. Only 
+     *        the destructor may be called afterwards.
+     */
+    std::vector<clause_t> releaseClauses() {
+        return std::move(this->clauses);
+    }
+
     void printStatistics() const;
 
+    /**
+     * @brief Write learned clauses with their LBD, VSIDS scores, saved 
+     *        phases and root-level units to @c filename
+     * @return false if the file cannot be written
+     */
+    bool saveSnapshot(const char *filename) const;
+
+    /**
+     * @brief Warm start from a snapshot written by @c saveSnapshot. 
+     *        Scores and phases are always taken; learned clauses and units 
+     *        only if the snapshot was taken on the same formula.
+     *        Must be called before @c DPLL.
+     * @return true if learned clauses and units were loaded as well
+     */
+    bool loadSnapshot(const char *filename);
+
 private:
 
+    /**
+     * @param[in] image The image @c clauses were read from, if any
+     */
+    void initialize(int maxVarIndex, const SolverOptions &options, const CNFImage *image=nullptr);
+
     void assign(int var, const clause_t *clause, int level=0);
 
     void unassign(int level);
 
+    inline bool isTrue(int var) const {
+        return this->assignments[std::abs(var)] == ((var > 0) ? TRUE : FALSE);
+    }
+
     /**
      * @return true if @c x in @c clause is been watching
      */
@@ -103,6 +329,26 @@ private:
      */
     int BCP(int x, int level);
 
+    /**
+     * @return The level on which @c clause implies @c x, that is @c level 
+     *         unless chronological backtracking put the other literals of 
+     *         @c clause on lower levels
+     */
+    int impliedLevel(const clause_t *clause, int x, int level) const;
+
+    /**
+     * @brief Learn from @c conflicting_clause and set @c jump_to
+     * @return ECONFLICT
+     */
+    int analyze(const clause_t *conflicting_clause, int level);
+
+    /**
+     * @brief Assign the literals implied by the XOR constraints
+     * @retval ECONFLICT if conflict
+     * @retval SUCCESS if no error
+     */
+    int gaussPropagate(int level);
+
     /**
      * @retval SAT if all the clauses are solved
      * @retval UNSAT if one of the clauses is UNSAT
@@ -117,10 +363,83 @@ private:
     static clause_t resolve(const clause_t *F, const clause_t *G, int x);
 
     /**
-     * @brief Implementation of 1UIP algorithm
+     * @brief Implementation of 1UIP algorithm. Antecedents subsumed by a 
+     *        resolvent are recorded in @c subsumed.
      * @return The conflicting clause associated with the 1UIP cut
      */
-    clause_t FirstUIP(const clause_t *conflicting_clause, int level) const;
+    clause_t FirstUIP(const clause_t *conflicting_clause, int level);
+
+    /**
+     * @return The clause in the database at @c clause, or nullptr if it is 
+     *         not there (e.g. a reason of an XOR implication)
+     */
+    clause_t *inDatabase(const clause_t *clause);
+
+    /**
+     * @brief Remove the resolved literal from the clauses in @c subsumed
+     * @param[in] jump_level The level which the solver backtracks to
+     */
+    void strengthenAntecedents(int jump_level);
+
+    /**
+     * @brief Watch the two literals of @c clause assigned last instead of 
+     *        the current ones; if it becomes unit after backtracking to 
+     *        @c jump_level, seed BCP to find it
+     */
+    void rewatch(clause_t &clause, int jump_level);
 
     void constructWatchingLists(const clause_t &clause);
+
+    /**
+     * @brief Detect symmetries of @c clauses and append clauses breaking 
+     *        them, which may add auxiliary variables
+     */
+    void breakSymmetries();
+
+    /**
+     * @brief Run bounded variable addition on @c clauses; the added 
+     *        variables follow @c nOriginalVars
+     */
+    void addVariables();
+
+    /**
+     * @brief Run ProbSAT on the original clauses, starting from the root 
+     *        assignment completed by the saved phases, and take its best 
+     *        assignment as the new phases
+     * @return true if local search found a model, which is then stored 
+     *         as the final answer
+     */
+    bool localSearch();
+
+    /**
+     * @brief Remove the clauses satisfied on the root level and strip the 
+     *        root-false literals of the others, then compact @c clauses 
+     *        and rebuild the watching lists. Must be called on level 0 
+     *        after BCP reached a fixpoint.
+     * @return false if a clause became empty, i.e. the formula is UNSAT
+     */
+    bool simplify();
+    /// Propagates the imply queue on @c level, false on a conflict
+    bool propagateCount(int level);
+    /// Splits what is left unassigned and unsatisfied of @c component 
+    /// into connected components
+    /// @return The number of its variables left in no unsatisfied clause
+    size_t decompose(const component_t &component, std::vector<component_t> &components);
+    BigNum countComponent(const component_t &component, int level);
+
+    /**
+     * @brief Evaluate the unsatisfied input clauses over every assignment
+     *        of the (at most @c TRUTH_TABLE_VARS) unassigned variables at 
+     *        once, 64 assignments per word. A model is assigned on level 
+     *        @c level + 1; otherwise the clauses up to the first one 
+     *        emptying the table form a conflict, which is analyzed.
+     * @return SAT, or UNSAT after a conflict
+     */
+    int truthTable(int level);
+
+    /**
+     * @return true (and set @c aborted) if the conflict or time budget 
+     *         is exhausted
+     */
+    bool outOfBudget();
 };
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "trace.hpp"
+
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+/// Events the drain thread moves from a ring per write
+#define TRACE_BATCH 4096UL
+#define TRACE_IDLE_MS 1
+
+TraceRing::TraceRing(uint16_t thread, size_t capacity)
+    : thread(thread), head(0UL), cached_tail(0UL), tail(0UL), cached_head(0UL), dropped(0ULL) {
+    size_t size = 1UL;
+    while (size < capacity)
+        size <<= 1;
+    this->events.resize(size);
+    this->mask = size - 1UL;
+}
+
+namespace {
+
+/// State shared by the solving threads and the drain thread
+struct TraceState {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceRing> > rings;
+    std::ofstream file;
+    std::thread drain;
+    std::atomic<bool> running{false};
+    /// Bumped by every start, so rings of an earlier trace are not reused
+    std::atomic<unsigned> generation{0U};
+    std::chrono::steady_clock::time_point origin;
+    size_t capacity;
+};
+
+TraceState state;
+
+thread_local TraceRing *local_ring = nullptr;
+thread_local unsigned local_generation = 0U;
+
+uint64_t elapsed() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - state.origin).count();
+}
+
+/// Writes the events of every ring, and a DROPPED event for the lost ones
+bool drainOnce(std::vector<trace_event> &batch) {
+    bool moved = false;
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto &ring : state.rings) {
+        size_t n;
+        while ((n = ring->pop(batch.data(), batch.size())) != 0UL) {
+            state.file.write(reinterpret_cast<const char *>(batch.data()), n * sizeof(trace_event));
+            moved = true;
+        }
+        uint64_t dropped = ring->takeDropped();
+        if (dropped != 0ULL) {
+            trace_event event = {elapsed(), TRACE_DROPPED, ring->getThread(),
+                                 {static_cast<int32_t>(std::min<uint64_t>(dropped, INT32_MAX)), 0, 0, 0, 0}};
+            state.file.write(reinterpret_cast<const char *>(&event), sizeof(event));
+        }
+    }
+    return moved;
+}
+
+void drainLoop() {
+    std::vector<trace_event> batch(TRACE_BATCH);
+    while (state.running.load(std::memory_order_acquire)) {
+        if (!drainOnce(batch))
+            std::this_thread::sleep_for(std::chrono::milliseconds(TRACE_IDLE_MS));
+    }
+    drainOnce(batch);
+}
+
+}
+
+void TraceRing::push(uint16_t type, int32_t a, int32_t b/*=0*/, int32_t c/*=0*/, int32_t d/*=0*/) {
+    size_t head = this->head.load(std::memory_order_relaxed);
+    if (head - this->cached_tail > this->mask) {
+        this->cached_tail = this->tail.load(std::memory_order_acquire);
+        if (head - this->cached_tail > this->mask) {
+            this->dropped.fetch_add(1ULL, std::memory_order_relaxed);
+            return;
+        }
+    }
+    this->events[head & this->mask] = {elapsed(), type, this->thread, {a, b, c, d, 0}};
+    this->head.store(head + 1UL, std::memory_order_release);
+}
+
+size_t TraceRing::pop(trace_event *out, size_t max) {
+    size_t tail = this->tail.load(std::memory_order_relaxed);
+    if (tail == this->cached_head) {
+        this->cached_head = this->head.load(std::memory_order_acquire);
+        if (tail == this->cached_head)
+            return 0UL;
+    }
+    size_t n = std::min(max, this->cached_head - tail);
+    for (size_t i = 0; i < n; ++i)
+        out[i] = this->events[(tail + i) & this->mask];
+    this->tail.store(tail + n, std::memory_order_release);
+    return n;
+}
+
+bool Tracer::start(const char *filename, size_t capacity/*=TRACE_RING_CAPACITY*/) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.running.load())
+        return false;
+    state.file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!state.file.is_open())
+        return false;
+    uint32_t header[4] = {0U, TRACE_VERSION, sizeof(trace_event), 0U};
+    std::memcpy(header, TRACE_MAGIC, 4);
+    state.file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    state.rings.clear();
+    state.capacity = capacity;
+    state.origin = std::chrono::steady_clock::now();
+    state.generation++;
+    state.running.store(true, std::memory_order_release);
+    state.drain = std::thread(drainLoop);
+    return true;
+}
+
+void Tracer::stop() {
+    if (!state.running.exchange(false))
+        return;
+    state.drain.join();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.file.close();
+}
+
+TraceRing *Tracer::local() {
+    if (!state.running.load(std::memory_order_acquire))
+        return nullptr;
+    if (local_ring == nullptr || local_generation != state.generation.load()) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.rings.emplace_back(new TraceRing(state.rings.size(), state.capacity));
+        local_ring = state.rings.back().get();
+        local_generation = state.generation.load();
+    }
+    return local_ring;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#define TRACE_MAGIC "YTRC"
+#define TRACE_VERSION 1U
+/// Events each thread may have in flight before new ones are dropped
+#define TRACE_RING_CAPACITY (1UL << 16)
+
+/// Kinds of trace events and the meaning of their arguments
+enum trace_event_t : uint16_t {
+    /// level, literal
+    TRACE_DECISION = 1,
+    /// level, jump level (-1 if no clause is learned), learned clause size, LBD
+    TRACE_CONFLICT,
+    /// restart number, conflicts so far, root-level assignments
+    TRACE_RESTART,
+    /// clauses kept, clauses removed, literals removed, root-level assignments
+    TRACE_REDUCTION,
+    /// events lost because the ring of the thread was full
+    TRACE_DROPPED
+};
+
+/// Record written to the trace file, after a header of magic, version and
+/// record size
+struct trace_event {
+    /// Nanoseconds since tracing started
+    uint64_t time;
+    uint16_t type;
+    /// Index of the ring, i.e. of the thread, which recorded it
+    uint16_t thread;
+    int32_t args[5];
+};
+
+/**
+ * @brief Single-producer single-consumer ring of trace events. The
+ *        solving thread pushes without locks or waiting, and drops the
+ *        event when the drain thread has fallen a full ring behind.
+ */
+class TraceRing {
+
+public:
+
+    TraceRing(uint16_t thread, size_t capacity);
+
+    /// Producer side
+    void push(uint16_t type, int32_t a, int32_t b=0, int32_t c=0, int32_t d=0);
+
+    /// Consumer side: moves up to @c max events to @c out
+    size_t pop(trace_event *out, size_t max);
+
+    /// Consumer side: events dropped since the last call
+    uint64_t takeDropped() {
+        return this->dropped.exchange(0ULL, std::memory_order_relaxed);
+    }
+
+    uint16_t getThread() const {
+        return this->thread;
+    }
+
+private:
+
+    std::vector<trace_event> events;
+    size_t mask;
+    uint16_t thread;
+    /// The indices only grow; each side caches the other one's to touch
+    /// its cache line only when the ring looks full or empty
+    alignas(64) std::atomic<size_t> head;
+    size_t cached_tail;
+    alignas(64) std::atomic<size_t> tail;
+    size_t cached_head;
+    alignas(64) std::atomic<uint64_t> dropped;
+
+};
+
+/**
+ * @brief Process-wide binary trace of the search. Every thread that
+ *        solves while tracing is on gets its own ring, and one background
+ *        thread drains all rings to the file.
+ */
+class Tracer {
+
+public:
+
+    /// @return false if tracing is already on or the file cannot be opened
+    static bool start(const char *filename, size_t capacity=TRACE_RING_CAPACITY);
+
+    /// Drains what is left, then closes the file
+    static void stop();
+
+    /// Ring of the calling thread, nullptr when tracing is off
+    static TraceRing *local();
+
+};
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+import os, sys, struct
+from collections import Counter, defaultdict
+
+DECISION, CONFLICT, RESTART, REDUCTION, DROPPED = range(1, 6)
+WINDOWS = 10
+
+def percentile(values, p):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p * len(values)))]
+
+def mean(values):
+    return sum(values) / len(values) if values else 0.0
+
+if __name__ == "__main__":
+
+    if len(sys.argv) < 2 or not os.path.isfile(sys.argv[1]):
+        print("Usage: " + sys.argv[0] + " </path/to/trace>")
+        exit()
+
+    with open(sys.argv[1], "rb") as trace:
+        magic, version, size, _ = struct.unpack("<4sIII", trace.read(16))
+        if magic != b"YTRC" or version != 1:
+            print("Not a yasat trace")
+            exit(1)
+        data = trace.read()
+
+    # time, type, thread, five arguments
+    record = struct.Struct("<QHH5i")
+    assert size == record.size
+    events = [record.unpack_from(data, i) for i in range(0, len(data) - size + 1, size)]
+    if not events:
+        print("Empty trace")
+        exit()
+
+    threads = defaultdict(list)
+    for event in events:
+        threads[event[2]].append(event)
+
+    for thread, events in sorted(threads.items()):
+
+        events.sort(key=lambda e: e[0])
+        begin, end = events[0][0], events[-1][0]
+        seconds = max(end - begin, 1) / 1e9
+        counts = Counter(e[1] for e in events)
+        conflicts = [e for e in events if e[1] == CONFLICT]
+        learned = [e for e in conflicts if e[4] >= 0]
+        restarts = [e for e in events if e[1] == RESTART]
+        reductions = [e for e in events if e[1] == REDUCTION]
+        dropped = sum(e[3] for e in events if e[1] == DROPPED)
+
+        print(f"thread {thread}: {len(events)} events over {seconds:.3f} s")
+        print(f"  decisions             : {counts[DECISION]} ({counts[DECISION] / seconds:.0f}/s)")
+        print(f"  conflicts             : {len(conflicts)} ({len(conflicts) / seconds:.0f}/s)")
+        print(f"  learned               : {len(learned)}, discarded {len(conflicts) - len(learned)}")
+        if learned:
+            sizes = [e[5] for e in learned]
+            lbds = [e[6] for e in learned if e[6] > 0]
+            jumps = [e[3] - e[4] for e in learned]
+            print(f"  learned size          : mean {mean(sizes):.2f}, p50 {percentile(sizes, 0.5)}, "
+                  f"p90 {percentile(sizes, 0.9)}, max {max(sizes)}")
+            print(f"  LBD                   : mean {mean(lbds):.2f}, p50 {percentile(lbds, 0.5)}, "
+                  f"p90 {percentile(lbds, 0.9)}")
+            print(f"  levels jumped         : mean {mean(jumps):.2f}, max {max(jumps)}")
+        if conflicts:
+            levels = [e[3] for e in conflicts]
+            print(f"  conflict level        : mean {mean(levels):.2f}, max {max(levels)}")
+        if restarts:
+            gaps = [b[4] - a[4] for a, b in zip(restarts, restarts[1:])]
+            print(f"  restarts              : {len(restarts)}, conflicts between mean {mean(gaps):.1f}, "
+                  f"root assignments at last {restarts[-1][5]}")
+        if reductions:
+            print(f"  reductions            : {len(reductions)}, removed {sum(e[4] for e in reductions)} "
+                  f"clauses and {sum(e[5] for e in reductions)} literals, "
+                  f"{reductions[-1][3]} clauses kept at last")
+        if dropped:
+            print(f"  dropped events        : {dropped}")
+
+        # Rates per window show where the search slows down
+        width = (end - begin) / WINDOWS or 1
+        decisions, conflicts_per_window = [0] * WINDOWS, [0] * WINDOWS
+        for e in events:
+            window = min(WINDOWS - 1, int((e[0] - begin) / width))
+            if e[1] == DECISION:
+                decisions[window] += 1
+            elif e[1] == CONFLICT:
+                conflicts_per_window[window] += 1
+        print("  window   decisions/s   conflicts/s")
+        for window in range(WINDOWS):
+            print(f"  {window:6d} {decisions[window] * 1e9 / width:13.0f} {conflicts_per_window[window] * 1e9 / width:13.0f}")
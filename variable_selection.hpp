@@ -17,4 +17,14 @@ public:
     virtual int getNextDicisionVariable() const = 0;
     virtual void update(const clause_t &clause) = 0;
 
+    /// Search events, for heuristics which learn from more than the
+    /// learned clauses. @c var is the literal made true or undone.
+    virtual void onAssign(int var) {}
+    virtual void onUnassign(int var) {}
+    /// Literals of the conflicting clause followed by those of every
+    /// antecedent resolved on, as they are in the clauses: signed and
+    /// with repeats, so take @c std::abs and skip variables already seen
+    virtual void onConflict(const std::vector<int> &participants) {}
+    virtual void onRestart() {}
+
 };
\ No newline at end of file
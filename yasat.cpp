@@ -0,0 +1,92 @@
+#include "yasat.h"
+#include "solver.hpp"
+
+#include <new>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+
+struct yasat {
+    SolverOptions options;
+    /// Clauses added by yasat_add_clauses, kept flat
+    std::vector<int> literals;
+    /// DIMACS assignments of the last model
+    std::vector<int> model;
+};
+
+/// Exceptions must not cross the C API, so a solver which throws (e.g. 
+/// out of memory) gives no answer
+static int solve(yasat_t *solver, const int *literals, size_t nLiterals, int maxVarIndex) {
+    solver->model.clear();
+    try {
+        std::unique_ptr<Solver> s(new Solver(literals, nLiterals, maxVarIndex, solver->options));
+        if (!s->DPLL())
+            return s->isAborted() ? YASAT_UNKNOWN : YASAT_UNSAT;
+        solver->model = s->getAssignments();
+        return YASAT_SAT;
+    }
+    catch (...) {
+        solver->model.clear();
+        return YASAT_UNKNOWN;
+    }
+}
+
+yasat_t *yasat_new(void) {
+    return new (std::nothrow) yasat;
+}
+
+void yasat_delete(yasat_t *solver) {
+    delete solver;
+}
+
+int yasat_set_option(yasat_t *solver, const char *name, long value) {
+    SolverOptions &options = solver->options;
+    if (!std::strcmp(name, "sls_interleave"))
+        options.sls_interleave = value;
+    else if (!std::strcmp(name, "sls_flips"))
+        options.sls_flips = value;
+    else if (!std::strcmp(name, "chrono"))
+        options.chrono_backtrack = value;
+    else if (!std::strcmp(name, "chrono_threshold"))
+        options.chrono_threshold = value;
+    else if (!std::strcmp(name, "gauss"))
+        options.gauss = value;
+    else if (!std::strcmp(name, "symmetry"))
+        options.symmetry_breaking = value;
+    else if (!std::strcmp(name, "bva"))
+        options.bva = value;
+    else if (!std::strcmp(name, "enumeration"))
+        options.enumeration = value;
+    else if (!std::strcmp(name, "conflict_budget"))
+        options.conflict_budget = value;
+    else if (!std::strcmp(name, "time_budget_ms"))
+        options.time_budget = value / 1000.0;
+    else
+        return 0;
+    return 1;
+}
+
+int yasat_add_clauses(yasat_t *solver, const int *literals, size_t nLiterals) {
+    try {
+        solver->literals.insert(solver->literals.end(), literals, literals + nLiterals);
+    }
+    catch (...) {
+        return 0;
+    }
+    return 1;
+}
+
+int yasat_solve(yasat_t *solver) {
+    return solve(solver, solver->literals.data(), solver->literals.size(), -1);
+}
+
+int yasat_solve_buffer(yasat_t *solver, const int *literals, size_t nLiterals,
+                       int maxVarIndex) {
+    return solve(solver, literals, nLiterals, maxVarIndex);
+}
+
+int yasat_value(const yasat_t *solver, int var) {
+    if (var <= 0 || static_cast<size_t>(var) > solver->model.size())
+        return 0;
+    return solver->model[var - 1];
+}
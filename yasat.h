@@ -0,0 +1,57 @@
+/*********************************************************************
+			   ================
+			     YaSat C API
+			   ================
+**********************************************************************/
+
+#ifndef __YASAT_H__
+#  define __YASAT_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Results of yasat_solve, as in IPASIR */
+#define YASAT_SAT 10
+#define YASAT_UNSAT 20
+/* The conflict or time budget ran out first */
+#define YASAT_UNKNOWN 0
+
+typedef struct yasat yasat_t;
+
+/* Create an empty instance; free it with yasat_delete. Returns NULL
+   if out of memory. */
+yasat_t *yasat_new(void);
+
+void yasat_delete(yasat_t *solver);
+
+/* Set a solver option by name, e.g. "chrono", "gauss", "symmetry",
+   "sls_interleave", "sls_flips", "chrono_threshold", "enumeration",
+   "bva", "conflict_budget", "time_budget_ms" (0 for no limit).
+   Returns 0 if the name is unknown. */
+int yasat_set_option(yasat_t *solver, const char *name, long value);
+
+/* Append zero-terminated clauses, e.g. {1, -2, 0, 2, 3, 0}, to the
+   formula of the next yasat_solve. Returns 0 if out of memory, in
+   which case the clauses are not added. */
+int yasat_add_clauses(yasat_t *solver, const int *literals, size_t nLiterals);
+
+/* Solve the clauses added so far. Errors inside the solver, such as
+   running out of memory, give YASAT_UNKNOWN. */
+int yasat_solve(yasat_t *solver);
+
+/* Solve the zero-terminated clauses in `literals' directly, without
+   buffering them; maxVarIndex is computed if negative */
+int yasat_solve_buffer(yasat_t *solver, const int *literals, size_t nLiterals,
+                       int maxVarIndex);
+
+/* After YASAT_SAT: var if it is true, -var if it is false */
+int yasat_value(const yasat_t *solver, int var);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
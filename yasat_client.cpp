@@ -0,0 +1,126 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#undef NDEBUG
+#include <cassert>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "yasatd.h"
+
+/**
+ * @brief Load generator for yasatd. Each of the concurrent clients keeps
+ *        one connection and sends the input files round robin until the
+ *        requested number of jobs is done, then latency percentiles and
+ *        throughput are reported.
+ */
+int main(int argc, char **argv) {
+
+    assert("Usage: ./yasat_client [--concurrency=C] [--jobs=N] [--time-budget-ms=T] [--conflict-budget=K] socket_path input.cnf..." && argc > 2);
+
+    unsigned concurrency = 1U, nJobs = 100U;
+    yasatd_request_header header = {0U, 0U, 0U};
+    const char *socket_path = nullptr;
+    std::vector<std::string> formulas;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strncmp(argv[i], "--concurrency=", 14))
+            concurrency = std::strtoul(argv[i] + 14, nullptr, 10);
+        else if (!std::strncmp(argv[i], "--jobs=", 7))
+            nJobs = std::strtoul(argv[i] + 7, nullptr, 10);
+        else if (!std::strncmp(argv[i], "--time-budget-ms=", 17))
+            header.time_budget_ms = std::strtoul(argv[i] + 17, nullptr, 10);
+        else if (!std::strncmp(argv[i], "--conflict-budget=", 18))
+            header.conflict_budget = std::strtoul(argv[i] + 18, nullptr, 10);
+        else if (socket_path == nullptr)
+            socket_path = argv[i];
+        else {
+            std::ifstream file(argv[i]);
+            assert("Cannot open the input file" && file.is_open());
+            std::stringstream text;
+            text << file.rdbuf();
+            formulas.push_back(text.str());
+        }
+    }
+    assert("No input file" && !formulas.empty() && concurrency > 0);
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    assert("Socket path too long" && std::strlen(socket_path) < sizeof(address.sun_path));
+    std::strcpy(address.sun_path, socket_path);
+
+    std::atomic<unsigned> next_job(0U);
+    std::atomic<unsigned> nSat(0U), nUnsat(0U), nUnknown(0U), nFailed(0U);
+    std::vector<std::vector<double> > latencies(concurrency);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (unsigned c = 0; c < concurrency; ++c)
+        clients.emplace_back([&, c] {
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0) {
+                nFailed++;
+                return;
+            }
+            std::string response;
+            for (unsigned job = next_job++; job < nJobs; job = next_job++) {
+                const std::string &formula = formulas[job % formulas.size()];
+                yasatd_request_header request = header;
+                request.length = formula.size();
+                auto sent = std::chrono::steady_clock::now();
+                uint32_t length;
+                if (!writeFully(fd, &request, sizeof(request)) ||
+                    !writeFully(fd, formula.data(), formula.size()) ||
+                    !readFully(fd, &length, sizeof(length))) {
+                    nFailed++;
+                    break;
+                }
+                response.resize(length);
+                if (!readFully(fd, &response[0], length)) {
+                    nFailed++;
+                    break;
+                }
+                latencies[c].push_back(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - sent).count());
+                if (response.find("s SATISFIABLE") != std::string::npos)
+                    nSat++;
+                else if (response.find("s UNSATISFIABLE") != std::string::npos)
+                    nUnsat++;
+                else
+                    nUnknown++;
+            }
+            close(fd);
+        });
+    for (auto &client : clients)
+        client.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto &l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) {
+        return all.empty() ? 0.0 : all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+    };
+
+    std::cout << "jobs                  : " << all.size() << " (" << nSat << " SAT, " << nUnsat
+              << " UNSAT, " << nUnknown << " UNKNOWN, " << nFailed << " failed)\n"
+              << "throughput            : " << all.size() / elapsed << " jobs/s\n"
+              << "latency p50           : " << percentile(0.50) << " ms\n"
+              << "latency p90           : " << percentile(0.90) << " ms\n"
+              << "latency p99           : " << percentile(0.99) << " ms\n"
+              << "latency max           : " << (all.empty() ? 0.0 : all.back()) << " ms\n";
+    return nFailed ? 1 : 0;
+}
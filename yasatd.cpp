@@ -0,0 +1,267 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <csignal>
+#include <cerrno>
+#include <exception>
+
+#undef NDEBUG
+#include <cassert>
+
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+#include "parser.h"
+#include "solver.hpp"
+#include "yasatd.h"
+
+#define DEFAULT_WORKERS 4U
+/// Stack frame of Solver::DPLL, measured at 192 bytes with g++ -O3 and 
+/// 208 with -O0, rounded up for other compilers
+#define DPLL_FRAME_BYTES 256U
+/// DPLL recurses once per decision level and a request has at most 
+/// YASATD_MAX_VARS of them; the non-recursive callees (BCP, conflict 
+/// analysis) get the 8 MB of a default thread on top. The stack is only 
+/// reserved, pages are committed as deep searches touch them.
+#define WORKER_STACK_BYTES \
+    (static_cast<size_t>(YASATD_MAX_VARS) * DPLL_FRAME_BYTES + (8U << 20))
+
+static volatile std::sig_atomic_t stopping = 0;
+
+static void onSignal(int) {
+    stopping = 1;
+}
+
+/**
+ * @brief Connections accepted by the main thread, waiting for a worker
+ */
+class ConnectionQueue {
+
+public:
+
+    void push(int fd) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->fds.push_back(fd);
+        }
+        this->ready.notify_one();
+    }
+
+    /// Blocks until a connection is available; -1 tells the worker to exit
+    int pop() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->ready.wait(lock, [this] { return !this->fds.empty(); });
+        int fd = this->fds.front();
+        this->fds.pop_front();
+        return fd;
+    }
+
+private:
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<int> fds;
+
+};
+
+/**
+ * @brief Serves the requests of one connection at a time. The buffers
+ *        keep their capacity between requests, so a warmed up worker
+ *        does not allocate for the request, the parsed literals, the
+ *        clauses or the response. The clause database is taken back from
+ *        each Solver and refilled in place; only the per variable arrays
+ *        of the Solver are allocated per request.
+ */
+class Worker {
+
+public:
+
+    void serve(int fd) {
+        // Reads time out, so idle clients cannot hold every worker
+        timeval timeout = {YASATD_IDLE_TIMEOUT_S, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        yasatd_request_header header;
+        while (readFully(fd, &header, sizeof(header))) {
+            if (header.length > YASATD_MAX_REQUEST)
+                break;
+            this->request.resize(header.length);
+            if (!readFully(fd, this->request.data(), header.length))
+                break;
+            this->solve(header);
+            uint32_t length = this->response.size();
+            if (!writeFully(fd, &length, sizeof(length)) ||
+                !writeFully(fd, this->response.data(), length))
+                break;
+        }
+        close(fd);
+    }
+
+private:
+
+    void solve(const yasatd_request_header &header) {
+
+        this->literals.clear();
+        this->response.clear();
+        int maxVarIndex;
+        if (!parse_DIMACS_buffer(this->literals, maxVarIndex, this->request.data(),
+                                 this->request.size(), YASATD_MAX_VARS)) {
+            this->response += "c parse error\ns UNKNOWN\n";
+            return;
+        }
+
+        SolverOptions options;
+        options.time_budget = header.time_budget_ms / 1000.0;
+        options.conflict_budget = header.conflict_budget;
+        // One request running out of memory must not take down the others
+        try {
+            this->fillClauses();
+            Solver solver(std::move(this->clauses), maxVarIndex, options);
+            this->respond(solver);
+            this->clauses = solver.releaseClauses();
+        }
+        catch (const std::exception &) {
+            this->clauses.clear();
+            this->response = "c error\ns UNKNOWN\n";
+        }
+    }
+
+    /// Overwrite the clauses of the previous request, learned ones
+    /// included, keeping their capacity
+    void fillClauses() {
+        size_t nClauses = 0;
+        const int *begin = this->literals.data();
+        const int *end = begin + this->literals.size();
+        // The parser terminates every clause with a zero
+        for (const int *p = begin; p != end; ++p) {
+            if (*p != 0)
+                continue;
+            if (nClauses < this->clauses.size())
+                this->clauses[nClauses].assign(begin, p);
+            else
+                this->clauses.emplace_back(begin, p);
+            ++nClauses;
+            begin = p + 1;
+        }
+        this->clauses.resize(nClauses);
+    }
+
+    void respond(Solver &solver) {
+        if (solver.DPLL()) {
+            this->response += "s SATISFIABLE\nv ";
+            char number[16];
+            for (int var : solver.getAssignments()) {
+                char *end = std::to_chars(number, number + sizeof(number), var).ptr;
+                this->response.append(number, end);
+                this->response += ' ';
+            }
+            this->response += "0\n";
+        }
+        else if (solver.isAborted())
+            this->response += "s UNKNOWN\n";
+        else
+            this->response += "s UNSATISFIABLE\n";
+    }
+
+    std::vector<char> request;
+    std::vector<int> literals;
+    std::vector<clause_t> clauses;
+    std::string response;
+
+};
+
+static void *work(void *queue) {
+    Worker worker;
+    ConnectionQueue *connections = static_cast<ConnectionQueue *>(queue);
+    for (int fd = connections->pop(); fd >= 0; fd = connections->pop())
+        worker.serve(fd);
+    return nullptr;
+}
+
+int main(int argc, char **argv) {
+
+    assert("Usage: ./yasatd [--workers=N] [--trace=F] socket_path" && argc > 1);
+
+    unsigned nWorkers = DEFAULT_WORKERS;
+    const char *socket_path = nullptr;
+    const char *trace_filename = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strncmp(argv[i], "--workers=", 10))
+            nWorkers = std::strtoul(argv[i] + 10, nullptr, 10);
+        else if (!std::strncmp(argv[i], "--trace=", 8))
+            trace_filename = argv[i] + 8;
+        else
+            socket_path = argv[i];
+    }
+    assert("No socket path" && socket_path != nullptr && nWorkers > 0);
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    assert("Socket path too long" && std::strlen(socket_path) < sizeof(address.sun_path));
+    std::strcpy(address.sun_path, socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert("Cannot create the socket" && listener >= 0);
+    unlink(socket_path);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        listen(listener, SOMAXCONN) < 0) {
+        std::cerr << "Cannot listen on " << socket_path << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    // A client hanging up must not kill the service; accept is
+    // interrupted (no SA_RESTART) so that the loop sees the stop request
+    std::signal(SIGPIPE, SIG_IGN);
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    // Each worker traces into its own ring
+    if (trace_filename != nullptr && !Tracer::start(trace_filename)) {
+        std::cerr << "Cannot write the trace " << trace_filename << "\n";
+        return 1;
+    }
+
+    // std::thread cannot set the stack size
+    ConnectionQueue queue;
+    std::vector<pthread_t> workers(nWorkers);
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, WORKER_STACK_BYTES);
+    for (auto &worker : workers) {
+        if (pthread_create(&worker, &attributes, work, &queue) != 0) {
+            std::cerr << "Cannot start a worker\n";
+            return 1;
+        }
+    }
+    pthread_attr_destroy(&attributes);
+
+    while (!stopping) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd >= 0)
+            queue.push(fd);
+        else if (errno != EINTR && errno != ECONNABORTED)
+            break;
+    }
+
+    // Connections already queued are served before the workers exit
+    for (unsigned i = 0; i < nWorkers; ++i)
+        queue.push(-1);
+    for (auto worker : workers)
+        pthread_join(worker, nullptr);
+    close(listener);
+    unlink(socket_path);
+    Tracer::stop();
+    return 0;
+}
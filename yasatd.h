@@ -0,0 +1,66 @@
+/*********************************************************************
+			   ================
+			   yasatd protocol
+			   ================
+**********************************************************************/
+
+#ifndef __YASATD_H__
+#  define __YASATD_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+#include <unistd.h>
+
+/* Requests larger than this close the connection */
+#define YASATD_MAX_REQUEST (256U << 20)
+/* The Solver allocates per variable index, so requests naming a larger
+   variable are answered with "c parse error" */
+#define YASATD_MAX_VARS (1 << 20)
+/* A worker serves one connection for as long as it stays open, so a
+   connection idle for this long between requests is closed to free the
+   worker for the queued ones */
+#define YASATD_IDLE_TIMEOUT_S 30
+
+/* A request is this header (native byte order, as the socket is local)
+   followed by `length' bytes of DIMACS CNF text.  The response is a
+   uint32_t length followed by the solution in the format of yasat's
+   .sat files, "s UNKNOWN" if a budget ran out or the request could not
+   be solved.  A connection may carry any number of requests, one after
+   another, as long as none is more than YASATD_IDLE_TIMEOUT_S late. */
+struct yasatd_request_header {
+    uint32_t length;
+    /* 0 for no limit */
+    uint32_t time_budget_ms;
+    uint32_t conflict_budget;
+};
+
+inline bool readFully(int fd, void *data, size_t size) {
+    char *p = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+inline bool writeFully(int fd, const void *data, size_t size) {
+    const char *p = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+#endif
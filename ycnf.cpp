@@ -0,0 +1,114 @@
+#include "ycnf.hpp"
+#include "snapshot.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool compileCNF(const std::vector<clause_t> &clauses, int maxVarIndex, const char *filename) {
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::vector<uint64_t> offsets(1, 0ULL);
+    std::vector<int32_t> occurrences(2 * (maxVarIndex + 1), 0);
+    for (const auto &clause : clauses) {
+        offsets.push_back(offsets.back() + clause.size());
+        for (int var : clause)
+            occurrences[(var > 0) ? 2 * var : -2 * var + 1]++;
+    }
+
+    ycnf_header header;
+    std::memcpy(header.magic, YCNF_MAGIC, 4);
+    header.version = YCNF_VERSION;
+    header.formula_hash = hashFormula(clauses, maxVarIndex);
+    header.maxVarIndex = maxVarIndex;
+    header.reserved = 0U;
+    header.nClauses = clauses.size();
+    header.nLiterals = offsets.back();
+
+    auto write = [&file](const void *data, size_t size) {
+        file.write(static_cast<const char *>(data), size);
+    };
+    write(&header, sizeof(header));
+    write(offsets.data(), offsets.size() * sizeof(uint64_t));
+    for (const auto &clause : clauses)
+        write(clause.data(), clause.size() * sizeof(int32_t));
+    write(occurrences.data(), occurrences.size() * sizeof(int32_t));
+
+    return file.good();
+}
+
+CNFImage::~CNFImage() {
+    if (this->image != nullptr)
+        munmap(this->image, this->length);
+}
+
+bool CNFImage::open(const char *filename) {
+
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(ycnf_header)) {
+        close(fd);
+        return false;
+    }
+    size_t length = st.st_size;
+    void *image = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED)
+        return false;
+    // The whole image is read front to back once
+    madvise(image, length, MADV_SEQUENTIAL | MADV_WILLNEED);
+
+    const ycnf_header *header = static_cast<const ycnf_header *>(image);
+    size_t nVars = std::max(header->maxVarIndex, 0);
+    // Each count is bounded by the file before the sizes are multiplied, so
+    // a corrupt header cannot wrap the expected length around to the real one
+    bool bounded = header->nClauses < length / sizeof(uint64_t) &&
+                   header->nLiterals < length / sizeof(int32_t) &&
+                   nVars < length / (2 * sizeof(int32_t));
+    size_t expected = bounded ? sizeof(ycnf_header) + sizeof(uint64_t) * (header->nClauses + 1) +
+                                    sizeof(int32_t) * (header->nLiterals + 2 * (nVars + 1))
+                              : 0;
+    if (std::memcmp(header->magic, YCNF_MAGIC, 4) || header->version != YCNF_VERSION ||
+        header->maxVarIndex < 0 || expected != length) {
+        munmap(image, length);
+        return false;
+    }
+
+    if (this->image != nullptr)
+        munmap(this->image, this->length);
+    this->image = image;
+    this->length = length;
+
+    const uint64_t *offsets = this->getOffsets();
+    bool sorted = offsets[0] == 0ULL && offsets[header->nClauses] == header->nLiterals;
+    for (uint64_t i = 0; i < header->nClauses && sorted; ++i)
+        sorted = offsets[i] <= offsets[i + 1];
+    // Literals index the watching lists of the solver
+    const int32_t *literals = this->getLiterals();
+    int32_t maxVar = header->maxVarIndex;
+    bool inRange = std::all_of(literals, literals + header->nLiterals, [maxVar](int32_t var) {
+        return var != 0 && var >= -maxVar && var <= maxVar;
+    });
+    if (!sorted || !inRange) {
+        munmap(this->image, this->length);
+        this->image = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool CNFImage::isImage(const char *filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[4];
+    return file.read(magic, 4) && !std::memcmp(magic, YCNF_MAGIC, 4);
+}
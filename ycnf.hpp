@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+typedef std::vector<int> clause_t;
+
+#define YCNF_MAGIC "YCNF"
+#define YCNF_VERSION 1U
+
+/**
+ * @brief Layout of a compiled CNF image. The header is followed by 
+ *        nClauses + 1 uint64 offsets into the literal arena, the int32 
+ *        literals of all clauses back to back and finally int32 pairs of 
+ *        occurrence counts of x and -x for every variable x (0 included),
+ *        so every section is naturally aligned.
+ */
+struct ycnf_header {
+    char magic[4];
+    uint32_t version;
+    /// Hash of the clauses, as computed by hashFormula
+    uint64_t formula_hash;
+    int32_t maxVarIndex;
+    uint32_t reserved;
+    uint64_t nClauses;
+    uint64_t nLiterals;
+};
+
+/**
+ * @brief Write the image of @c clauses to @c filename
+ * @return false if the file cannot be written
+ */
+bool compileCNF(const std::vector<clause_t> &clauses, int maxVarIndex, const char *filename);
+
+/**
+ * @brief Read-only view of a compiled CNF image mapped into memory
+ */
+class CNFImage {
+
+public:
+
+    CNFImage() : image(nullptr), length(0) {}
+
+    CNFImage(const CNFImage &) = delete;
+    CNFImage &operator=(const CNFImage &) = delete;
+
+    ~CNFImage();
+
+    /**
+     * @return false if @c filename cannot be mapped or is not a valid image
+     */
+    bool open(const char *filename);
+
+    const ycnf_header &getHeader() const {
+        return *static_cast<const ycnf_header *>(this->image);
+    }
+
+    /// Clause i is literals[offsets[i] .. offsets[i + 1])
+    const uint64_t *getOffsets() const {
+        return reinterpret_cast<const uint64_t *>(static_cast<const char *>(this->image) + 
+                                                  sizeof(ycnf_header));
+    }
+
+    const int32_t *getLiterals() const {
+        return reinterpret_cast<const int32_t *>(this->getOffsets() + this->getHeader().nClauses + 1);
+    }
+
+    /// Occurrences of x at 2 * |x| (positive) or 2 * |x| + 1 (negative)
+    const int32_t *getOccurrences() const {
+        return this->getLiterals() + this->getHeader().nLiterals;
+    }
+
+    /// True if @c filename starts with the image magic
+    static bool isImage(const char *filename);
+
+private:
+
+    void *image;
+    size_t length;
+
+};